@@ -107,6 +107,23 @@ else
     exit 1
 fi
 
+# 检查可选的推理后端（未安装时只使用OpenCV DNN）
+echo -e "检查可选推理后端..."
+BACKEND_CFLAGS=""
+BACKEND_LIBS=""
+if pkg-config --exists libonnxruntime
+then
+    BACKEND_CFLAGS="$BACKEND_CFLAGS -DHAVE_ONNXRUNTIME $(pkg-config --cflags libonnxruntime)"
+    BACKEND_LIBS="$BACKEND_LIBS $(pkg-config --libs libonnxruntime)"
+    echo -e "${GREEN}✓ 找到ONNX Runtime${NC}"
+fi
+if pkg-config --exists tensorflow-lite
+then
+    BACKEND_CFLAGS="$BACKEND_CFLAGS -DHAVE_TFLITE $(pkg-config --cflags tensorflow-lite)"
+    BACKEND_LIBS="$BACKEND_LIBS $(pkg-config --libs tensorflow-lite)"
+    echo -e "${GREEN}✓ 找到TensorFlow Lite${NC}"
+fi
+
 # 创建构建目录
 BUILD_DIR="build_linux"
 if [ ! -d "$BUILD_DIR" ]
@@ -118,7 +135,7 @@ else
 fi
 
 # 收集所有源文件
-SOURCE_FILES=(src/main.cpp src/core/AICompanion.cpp src/location/LocationTracker.cpp src/location/AmapAPI.cpp src/vision/VisionProcessor.cpp src/vision/model_utils.cpp src/cultural/CulturalGuide.cpp src/chat/Chatbot.cpp src/sensor/SensorManager.cpp)
+SOURCE_FILES=(src/main.cpp src/core/AICompanion.cpp src/core/SubsystemScheduler.cpp src/core/CommandInput.cpp src/core/EventBus.cpp src/core/SubsystemInitializer.cpp src/location/LocationTracker.cpp src/location/AmapAPI.cpp src/vision/VisionProcessor.cpp src/vision/model_utils.cpp src/vision/FrameBufferPool.cpp src/vision/preprocess.cpp src/vision/yolo_decoder.cpp src/vision/SceneChangeGate.cpp src/vision/FrameQualityGate.cpp src/vision/ObjectTracker.cpp src/vision/InferenceBackend.cpp src/vision/Detection.cpp src/vision/FrameSource.cpp src/vision/PipelineStats.cpp src/vision/VisionBenchmark.cpp src/vision/FrameRecorder.cpp src/vision/ResolutionController.cpp src/vision/ArtifactClassifier.cpp src/vision/InscriptionReader.cpp src/cultural/CulturalGuide.cpp src/chat/Chatbot.cpp src/sensor/SensorManager.cpp)
 
 # 检查源文件是否存在
 for file in "${SOURCE_FILES[@]}"
@@ -131,13 +148,13 @@ do
 done
 
 # 编译选项 - 设置包含路径以确保编译器能找到所有头文件
-CXXFLAGS="-std=c++11 -Wall -O2 -D_X86 -Iinclude -I../include -I/usr/include $OPENCV_CFLAGS $CURL_CFLAGS $JSON_CFLAGS"
+CXXFLAGS="-std=c++11 -pthread -Wall -O2 -D_X86 -Iinclude -I../include -I/usr/include $OPENCV_CFLAGS $CURL_CFLAGS $JSON_CFLAGS $BACKEND_CFLAGS"
 
 # 开始编译
 cd "$BUILD_DIR"
 echo -e "开始编译项目..."
 
-g++ $CXXFLAGS ../src/main.cpp ../src/core/AICompanion.cpp ../src/location/LocationTracker.cpp ../src/location/AmapAPI.cpp ../src/vision/VisionProcessor.cpp ../src/vision/model_utils.cpp ../src/cultural/CulturalGuide.cpp ../src/chat/Chatbot.cpp ../src/sensor/SensorManager.cpp -o AICompanion $OPENCV_LIBS $CURL_LIBS $JSON_LIBS
+g++ $CXXFLAGS ../src/main.cpp ../src/core/AICompanion.cpp ../src/core/SubsystemScheduler.cpp ../src/core/CommandInput.cpp ../src/core/EventBus.cpp ../src/core/SubsystemInitializer.cpp ../src/location/LocationTracker.cpp ../src/location/AmapAPI.cpp ../src/vision/VisionProcessor.cpp ../src/vision/model_utils.cpp ../src/vision/FrameBufferPool.cpp ../src/vision/preprocess.cpp ../src/vision/yolo_decoder.cpp ../src/vision/SceneChangeGate.cpp ../src/vision/FrameQualityGate.cpp ../src/vision/ObjectTracker.cpp ../src/vision/InferenceBackend.cpp ../src/vision/Detection.cpp ../src/vision/FrameSource.cpp ../src/vision/PipelineStats.cpp ../src/vision/VisionBenchmark.cpp ../src/vision/FrameRecorder.cpp ../src/vision/ResolutionController.cpp ../src/vision/ArtifactClassifier.cpp ../src/vision/InscriptionReader.cpp ../src/cultural/CulturalGuide.cpp ../src/chat/Chatbot.cpp ../src/sensor/SensorManager.cpp -o AICompanion $OPENCV_LIBS $CURL_LIBS $JSON_LIBS $BACKEND_LIBS
 
 # 检查编译是否成功
 if [ $? -eq 0 ]
@@ -56,10 +56,16 @@ public:
     // 调用智谱AI GLM-Realtime API
     std::string callZhipuAIGLMAPI(const std::string& prompt);
     
+    // 设置当前场景（例如所在景区），调用API时附加在用户输入之前
+    void setSceneContext(const std::string& context);
+    
 private:
     // 对话模式
     ChatMode currentMode;
     
+    // 当前场景描述
+    std::string sceneContext;
+    
     // 对话历史
     std::vector<ConversationEntry> conversationHistory;
     
@@ -3,6 +3,11 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include "core/SubsystemScheduler.h"
+#include "core/SubsystemInitializer.h"
+#include "core/EventBus.h"
 #include "location/LocationTracker.h"
 #include "vision/VisionProcessor.h"
 #include "cultural/CulturalGuide.h"
@@ -19,9 +24,6 @@ public:
     bool initialize();
     void shutdown();
     
-    // 主循环更新
-    void update();
-    
     // 核心功能接口
     void getCurrentLocation();
     void startDetection();
@@ -53,21 +55,66 @@ private:
     
     // 系统状态
     bool isInitialized;
-    bool isDetecting;
+    std::atomic<bool> isDetecting;
+    
+    // 子系统按依赖关系并行初始化，视觉和文化知识库在后台完成（声明在eventBus之前，
+    // 事件消费者可能在等待后台初始化）
+    SubsystemInitializer initializer;
+    int visionStepId;
+    int knowledgeStepId;
+    
+    // 子系统之间的事件：定位、视觉、传感器发布事件，讲解、对话（以及可选的日志）消费者
+    // 在各自的线程中只在有新事件时处理（声明在scheduler之前，析构时后于调度器停止）
+    EventBus eventBus;
+    
+    // 子系统调度：IMU、GPS定位和围栏检查、其他传感器（ESP32上还有视觉）各自按自己的频率运行，
+    // 由调度器的线程调用下面的updateXxx()；命令处理在主线程中进行，
+    // 通过以下互斥锁与调度线程和事件消费者线程同步
+    SubsystemScheduler scheduler;
+#ifdef ESP32
+    int visionTaskId;
+#endif
+    std::mutex sensorMutex;      // sensorManager
+    std::mutex locationMutex;    // locationTracker和景区讲解状态
+    std::mutex visionMutex;      // visionProcessor的启停和已讲解目标的记录
+    std::mutex chatMutex;        // chatbot
     
     // 景区讲解状态
-    bool isScenicSpotExplaining;
+    std::atomic<bool> isScenicSpotExplaining;
     std::string currentScenicSpot;
     
+    // 已讲解过、且仍在画面中的目标（按跟踪ID；没有跟踪ID的按标签ID）
+    // 每帧的目标数量很少，用复用的数组代替集合，避免每次更新都分配节点
+    std::vector<int> explainedTracks;
+    std::vector<int> explainedLabels;
+    std::vector<int> visibleTracks;
+    std::vector<int> visibleLabels;
+    
+    // 已按识别出的文字讲解过、且仍在画面中的碑文和书法作品（按跟踪ID）
+    std::vector<RecognizedInscription> inscriptions;
+    std::vector<int> explainedInscriptions;
+    std::vector<int> visibleInscriptions;
+    
     // 设备兼容性检测
     bool detectDeviceType();
     bool setupHardware();
     
+    // 调度任务
+    void updateSensorData();       // IMU
+    void updateOtherSensors();     // 摄像头、麦克风、温度等其他传感器
+    void updateLocation();         // GPS定位和景区围栏检查
+#ifdef ESP32
+    void updateVisionDetection();  // 同步采集和检测一帧
+#endif
+    
+    // 事件消费者
+    void registerEventConsumers();
+    void onFenceEntered(const FenceEnteredEvent& event);              // 讲解：进入新景区
+    void onDetectionsUpdated(const DetectionsUpdatedEvent& event);    // 讲解：新的检测结果
+    void onUserQuery(const UserQueryEvent& event);                    // 对话：回复用户
+    void updateChatContext(const FenceEnteredEvent& event);           // 对话：更新所在景区
+    
     // 私有方法
-    void updateSensorData();
-    void updateLocation();
-    void updateVisionDetection();
-    void checkScenicSpotEntry();
     void startScenicSpotExplanation();
 };
 
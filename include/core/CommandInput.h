@@ -0,0 +1,37 @@
+#ifndef COMMAND_INPUT_H
+#define COMMAND_INPUT_H
+
+#include <string>
+#include <thread>
+#include "utils/BoundedQueue.h"
+
+/**
+ * @brief 后台读取用户命令
+ *
+ * 独立的输入线程阻塞在std::getline上，读到的每一行放入命令队列，主线程从队列中取出命令
+ * 交给AICompanion处理。等待输入不会占用主线程，也不会影响调度器中各子系统的更新频率。
+ * 读到exit/quit或输入结束（EOF）后输入线程退出，并关闭队列。
+ * 析构时等待输入线程结束，应在取到exit/quit或nextCommand()返回false之后再销毁。
+ */
+class CommandInput {
+public:
+    CommandInput();
+    ~CommandInput();
+
+    // 启动输入线程
+    void start();
+
+    // 阻塞等待下一条命令；输入结束且队列中没有命令时返回false
+    bool nextCommand(std::string& command);
+
+private:
+    // 命令由用户逐条输入，队列不会积压；队列满时输入线程等待，不丢弃命令
+    static const size_t kQueueCapacity = 16;
+
+    BoundedQueue<std::string> commands;
+    std::thread reader;
+
+    void readLoop();
+};
+
+#endif // COMMAND_INPUT_H
@@ -0,0 +1,202 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <cstddef>
+#include "utils/MpscRing.h"
+
+enum class SensorType;
+
+// 事件类型（每种事件结构体的kType）
+enum class EventType {
+    FenceEntered,
+    DetectionsUpdated,
+    SensorSample,
+    UserQuery
+};
+const size_t kEventTypeCount = 4;
+
+// 进入新景区的电子围栏（LocationTracker发布）
+struct FenceEnteredEvent {
+    static const EventType kType = EventType::FenceEntered;
+    std::string scenicSpot;
+    std::string lastScenicSpot;
+    double latitude;
+    double longitude;
+
+    FenceEnteredEvent() : latitude(0.0), longitude(0.0) {}
+};
+
+// 发布了新的检测结果（VisionProcessor发布）；事件只带序号，结果本身通过getDetections()的视图读取，不复制
+struct DetectionsUpdatedEvent {
+    static const EventType kType = EventType::DetectionsUpdated;
+    int cameraId;
+    unsigned long frameId;
+    size_t detectionCount;
+
+    DetectionsUpdatedEvent() : cameraId(0), frameId(0), detectionCount(0) {}
+};
+
+// 一次传感器读数（SensorManager发布）
+struct SensorSampleEvent {
+    static const EventType kType = EventType::SensorSample;
+    SensorType type;
+    double value;
+    bool isValid;
+    std::chrono::steady_clock::time_point timestamp;
+
+    SensorSampleEvent() : type(), value(0.0), isValid(false) {}
+};
+
+// 用户的对话输入（AICompanion发布）
+struct UserQueryEvent {
+    static const EventType kType = EventType::UserQuery;
+    std::string query;
+};
+
+// 一个订阅的投递统计
+struct EventSubscriptionStats {
+    std::string consumer;
+    EventType type;
+    size_t delivered;
+    size_t dropped;     // 订阅队列满而丢弃的事件数
+
+    EventSubscriptionStats() : type(EventType::FenceEntered), delivered(0), dropped(0) {}
+};
+
+/**
+ * @brief 子系统之间的发布/订阅事件总线
+ *
+ * 每个消费者（例如讲解、对话、日志）有自己的线程，为订阅的每种事件准备一个有界无锁队列（MpscRing）。
+ * 生产者发布一次，事件复制进各订阅者的队列后立即返回，不加锁、不等待消费者；
+ * 消费者只在有新事件时被唤醒，在自己的线程中按订阅顺序轮流处理各队列的事件。
+ * 订阅队列满时丢弃新事件并计数。消费者和订阅需要在start()之前注册，之后订阅关系不再变化。
+ */
+class EventBus {
+public:
+    // queueCapacity为每个订阅队列的容量
+    explicit EventBus(size_t queueCapacity = 64);
+    ~EventBus();
+
+    // 注册消费者，返回消费者ID（运行中返回-1）
+    int addConsumer(const std::string& name);
+
+    // 为消费者订阅一种事件，handler在消费者线程中调用
+    template <typename E>
+    bool subscribe(int consumerId, const std::function<void(const E&)>& handler);
+
+    // 发布事件（任意线程）；总线没有运行时事件被忽略
+    template <typename E>
+    void publish(const E& event);
+
+    // 启动各消费者线程
+    void start();
+
+    // 停止各消费者线程（队列中还没有处理的事件被丢弃）
+    void stop();
+
+    bool isRunning() const { return running; }
+
+    // 各订阅的投递统计
+    std::vector<EventSubscriptionStats> getStats() const;
+
+private:
+    struct Consumer;
+
+    struct SubscriptionBase {
+        EventType type;
+        Consumer* consumer;
+        std::atomic<size_t> delivered;
+        std::atomic<size_t> dropped;
+
+        SubscriptionBase(EventType type, Consumer* consumer)
+            : type(type), consumer(consumer), delivered(0), dropped(0) {}
+        virtual ~SubscriptionBase() {}
+
+        // 处理队列中的一个事件，队列为空时返回false
+        virtual bool dispatchOne() = 0;
+        virtual bool pending() const = 0;
+    };
+
+    template <typename E>
+    struct Subscription : SubscriptionBase {
+        MpscRing<E> ring;
+        std::function<void(const E&)> handler;
+        E current;   // 出队的事件（在事件之间复用）
+
+        Subscription(Consumer* consumer, size_t capacity, const std::function<void(const E&)>& handler)
+            : SubscriptionBase(E::kType, consumer), ring(capacity), handler(handler) {}
+
+        bool dispatchOne() {
+            if (!ring.tryPop(current)) {
+                return false;
+            }
+            handler(current);
+            delivered.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool pending() const { return !ring.empty(); }
+    };
+
+    struct Consumer {
+        std::string name;
+        std::vector<SubscriptionBase*> subscriptions;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<bool> sleeping;   // 消费者没有事件可处理、正在等待唤醒
+
+        Consumer() : sleeping(false) {}
+    };
+
+    size_t queueCapacity;
+    std::vector<std::unique_ptr<Consumer> > consumers;
+    std::vector<std::unique_ptr<SubscriptionBase> > subscriptions;
+    std::vector<SubscriptionBase*> channels[kEventTypeCount];   // 每种事件的订阅，start()之后只读
+    std::atomic<bool> running;
+
+    void consumerLoop(Consumer* consumer);
+
+    // 唤醒正在等待的消费者（生产者在入队后调用）
+    void notify(Consumer& consumer);
+};
+
+template <typename E>
+bool EventBus::subscribe(int consumerId, const std::function<void(const E&)>& handler) {
+    if (running || consumerId < 0 || static_cast<size_t>(consumerId) >= consumers.size() || !handler) {
+        return false;
+    }
+    Consumer* consumer = consumers[static_cast<size_t>(consumerId)].get();
+    std::unique_ptr<SubscriptionBase> subscription(new Subscription<E>(consumer, queueCapacity, handler));
+    consumer->subscriptions.push_back(subscription.get());
+    channels[static_cast<size_t>(E::kType)].push_back(subscription.get());
+    subscriptions.push_back(std::move(subscription));
+    return true;
+}
+
+template <typename E>
+void EventBus::publish(const E& event) {
+    if (!running.load(std::memory_order_acquire)) {
+        return;
+    }
+    for (SubscriptionBase* base : channels[static_cast<size_t>(E::kType)]) {
+        // 同一种事件的订阅都由subscribe<E>()创建
+        Subscription<E>* subscription = static_cast<Subscription<E>*>(base);
+        if (subscription->ring.tryPush(event)) {
+            notify(*subscription->consumer);
+        } else {
+            subscription->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,94 @@
+#ifndef SUBSYSTEM_INITIALIZER_H
+#define SUBSYSTEM_INITIALIZER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+// 初始化步骤的状态
+enum class InitState {
+    Pending,   // 等待依赖的步骤完成
+    Running,
+    Ready,
+    Failed     // 步骤失败，或依赖的步骤失败而没有运行
+};
+
+// 一个初始化步骤的状态和耗时
+struct InitStepStatus {
+    std::string name;
+    InitState state;
+    bool background;
+    double elapsedMs;   // 运行耗时（还没有结束时为已运行的时间）
+
+    InitStepStatus() : state(InitState::Pending), background(false), elapsedMs(0.0) {}
+};
+
+/**
+ * @brief 按依赖关系并行初始化子系统
+ *
+ * 每个子系统注册为一个初始化步骤，并声明依赖的步骤。run()为每个步骤启动一个线程，
+ * 依赖的步骤全部成功后才开始运行，互不依赖的步骤并行进行；依赖的步骤失败时该步骤直接记为失败。
+ * run()只等待前台步骤，后台步骤（例如模型、大型知识库）在run()返回后继续进行，
+ * 使用方通过isReady()/waitFor()查询或等待，getStatus()用于显示各步骤的就绪状态。
+ */
+class SubsystemInitializer {
+public:
+    typedef std::function<bool()> Step;
+
+    SubsystemInitializer();
+    ~SubsystemInitializer();
+
+    // 注册初始化步骤（需要在run()之前调用），dependencies为之前注册的步骤ID；
+    // background为true时run()不等待它完成。返回步骤ID，参数无效时返回-1
+    int addStep(const std::string& name, const std::vector<int>& dependencies, bool background, const Step& step);
+
+    // 开始运行所有步骤，等待前台步骤结束；任一前台步骤失败时返回false（其余步骤照常结束）
+    bool run();
+
+    // 等待所有步骤（包括后台步骤）结束
+    void waitAll();
+
+    // 等待一个步骤结束，返回是否成功
+    bool waitFor(int stepId);
+
+    // 步骤是否已成功完成（不等待）
+    bool isReady(int stepId) const;
+
+    InitState getState(int stepId) const;
+
+    // 各步骤的状态（按注册顺序）
+    std::vector<InitStepStatus> getStatus() const;
+
+    // 等待所有步骤结束后清空，之后可以重新注册
+    void clear();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct StepState {
+        std::string name;
+        std::vector<int> dependencies;
+        bool background;
+        Step step;
+        InitState state;
+        Clock::time_point startTime;
+        Clock::time_point endTime;
+
+        StepState() : background(false), state(InitState::Pending) {}
+    };
+
+    std::vector<StepState> steps;
+    std::vector<std::thread> threads;
+    mutable std::mutex mutex;
+    std::condition_variable changed;   // 有步骤结束时通知
+    bool started;
+
+    void runStep(size_t index);
+    static bool finished(InitState state) { return state == InitState::Ready || state == InitState::Failed; }
+};
+
+#endif // SUBSYSTEM_INITIALIZER_H
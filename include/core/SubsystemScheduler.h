@@ -0,0 +1,113 @@
+#ifndef SUBSYSTEM_SCHEDULER_H
+#define SUBSYSTEM_SCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstddef>
+
+// 一个周期任务的时序统计
+struct ScheduledTaskStats {
+    std::string name;
+    float rateHz;
+    int priority;
+    bool dedicatedThread;
+    size_t runs;
+    size_t overruns;          // 单次运行时间超过周期的次数
+    size_t missedReleases;    // 因运行超时或调度延迟而跳过的周期数
+    double meanJitterMs;      // 实际开始时间相对计划时间的平均延迟
+    double maxJitterMs;
+    double meanRunMs;
+    double maxRunMs;
+
+    ScheduledTaskStats()
+        : rateHz(0.0f), priority(0), dedicatedThread(false), runs(0), overruns(0), missedReleases(0),
+          meanJitterMs(0.0), maxJitterMs(0.0), meanRunMs(0.0), maxRunMs(0.0) {}
+};
+
+/**
+ * @brief 多速率子系统调度器
+ *
+ * 每个子系统以目标频率和优先级注册一个周期任务，各自按自己的节拍运行，慢的子系统不会拖慢快的子系统。
+ * 高频、对时序敏感的任务（例如IMU）使用独占线程；其余任务共享几个工作线程，
+ * 同时到期的任务中优先级高的先运行，同一个任务不会并发运行。
+ *
+ * 任务按固定节拍（开始时间 + n×周期）释放，不会因为一次慢运行而漂移。一次运行超过周期时记一次超时
+ * （同一任务每秒最多打印一次警告），已经错过的节拍直接跳过并计数，之后不会连续补跑。
+ * 每次运行记录开始时间相对计划时间的延迟（抖动）和运行耗时。
+ */
+class SubsystemScheduler {
+public:
+    typedef std::function<void()> Task;
+
+    // pooledThreads为共享工作线程的数量（至少1个）
+    explicit SubsystemScheduler(size_t pooledThreads = 2);
+    ~SubsystemScheduler();
+
+    // 注册周期任务（需要在start()之前调用），rateHz为目标频率，priority越大越优先，
+    // dedicatedThread为true时使用独占线程；返回任务ID，参数无效时返回-1
+    int addTask(const std::string& name, float rateHz, int priority, bool dedicatedThread, const Task& task);
+
+    // 修改任务频率，运行中也可以调用，从下一个节拍开始生效
+    bool setRate(int taskId, float rateHz);
+
+    // 暂停或恢复任务（默认启用）；恢复后立即运行一次
+    void setEnabled(int taskId, bool enabled);
+
+    // 启动所有任务，所有启用的任务立即运行第一次
+    void start();
+
+    // 停止调度，等待正在运行的任务结束
+    void stop();
+
+    bool isRunning() const;
+
+    // 各任务的时序统计
+    std::vector<ScheduledTaskStats> getStats() const;
+
+    // 清空统计
+    void resetStats();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct TaskState {
+        std::string name;
+        Task task;
+        int priority;
+        bool dedicated;
+        Clock::duration period;
+        Clock::time_point nextRelease;
+        bool enabled;
+        bool active;          // 正在运行
+        Clock::time_point lastOverrunWarning;
+        ScheduledTaskStats stats;
+        double jitterSumMs;
+        double runSumMs;
+
+        TaskState() : priority(0), dedicated(false), enabled(true), active(false), jitterSumMs(0.0), runSumMs(0.0) {}
+    };
+
+    size_t pooledThreadCount;
+    std::vector<std::unique_ptr<TaskState> > tasks;
+    std::vector<std::thread> threads;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+
+    // 共享工作线程：挑选已到期、没有在运行、优先级最高的任务
+    void poolLoop();
+
+    // 独占线程：按节拍运行一个任务
+    void dedicatedLoop(TaskState* task);
+
+    // 运行一次任务并记录统计（调用时持有lock，运行期间释放）
+    void runTask(TaskState& task, std::unique_lock<std::mutex>& lock);
+};
+
+#endif // SUBSYSTEM_SCHEDULER_H
@@ -25,6 +25,10 @@ public:
     // 获取对象的文化讲解
     std::string getExplanation(const std::string& objectName);
     
+    // 按识别出的文字（例如碑文、书法作品上的文字）查找文化讲解：文字中出现知识库里的
+    // 对象名称或标题时返回对应的讲解，没有找到时返回空字符串
+    std::string getExplanationForText(const std::string& text);
+    
     // 获取景点的文化信息
     std::vector<CulturalInfo> getLocationInfo(const std::string& locationName);
     
@@ -6,6 +6,8 @@
 #include <map>
 #include <cmath>
 
+class EventBus;
+
 // 位置信息结构体
 typedef struct {
     double latitude;      // 纬度
@@ -33,7 +35,7 @@ public:
     // 初始化定位系统
     bool initialize();
     
-    // 更新位置信息
+    // 更新位置信息（每次调用为一次定位，由调度器按GPS的定位频率调用）
     void update();
     
     // 获取当前位置
@@ -60,6 +62,9 @@ public:
     // 重置位置追踪系统
     void reset();
     
+    // 设置事件总线，进入新景区时发布FenceEnteredEvent（为空时不发布）
+    void setEventBus(EventBus* bus);
+    
 private:
     // 当前位置信息
     LocationInfo currentLocation;
@@ -69,11 +74,16 @@ private:
     bool gpsAvailable;
     bool imuAvailable;
     
+    // 模拟定位的次数（决定模拟的当前位置）
+    int simulatedFixCount;
+    
     // 电子围栏相关
     std::vector<ScenicSpotFence> scenicSpotFences; // 景区电子围栏列表
     std::string currentScenicSpot;                  // 当前所在景区
     std::string lastScenicSpot;                     // 上一次所在景区
     
+    EventBus* eventBus;
+    
     // 初始化景区电子围栏
     void initializeScenicSpotFences();
     
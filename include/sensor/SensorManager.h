@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+class EventBus;
+
 // 传感器类型枚举
 enum class SensorType {
     GPS,        // 全球定位系统
@@ -46,6 +48,9 @@ public:
     // 更新传感器数据
     void update();
     
+    // 只更新指定类型的传感器（不同传感器按各自的频率调度时使用）
+    void update(SensorType type);
+    
     // 获取传感器数据
     std::vector<SensorData> getSensorData(SensorType type);
     
@@ -68,6 +73,9 @@ public:
     // 获取所有传感器状态
     std::vector<SensorStatus> getAllSensorStatus();
     
+    // 设置事件总线，每次读数发布一个SensorSampleEvent（为空时不发布）
+    void setEventBus(EventBus* bus);
+    
 private:
     // 传感器状态列表
     std::vector<SensorStatus> sensors;
@@ -75,6 +83,8 @@ private:
     // 传感器数据缓存
     std::vector<SensorData> sensorDataCache;
     
+    EventBus* eventBus;
+    
     // 初始化传感器
     bool initializeSensors();
     
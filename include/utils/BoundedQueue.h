@@ -0,0 +1,162 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief 有界阻塞队列，队列满时丢弃最旧的元素（drop-oldest背压策略）
+ *
+ * 用于视觉流水线各阶段之间传递数据：生产者永远不会被阻塞，
+ * 消费者处理不过来时只保留最新的数据。内部使用定长环形缓冲区，
+ * 入队出队不产生堆分配。离线回放需要处理每一帧时改用pushWait()，
+ * 队列满时等待消费者而不是丢弃。
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : buffer(capacity > 0 ? capacity : 1), head(0), count(0),
+          closed(false), dropped(0) {}
+
+    /**
+     * @brief 入队，队列已满时丢弃最旧的元素
+     * @param item 要入队的元素
+     * @param droppedItem 若不为空，被丢弃的元素会移动到这里
+     * @return 是否发生了丢弃
+     */
+    bool push(const T& item, T* droppedItem = nullptr) {
+        bool didDrop = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == buffer.size()) {
+                // 队列已满，丢弃最旧的元素
+                if (droppedItem) {
+                    *droppedItem = buffer[head];
+                }
+                head = (head + 1) % buffer.size();
+                --count;
+                ++dropped;
+                didDrop = true;
+            }
+            buffer[(head + count) % buffer.size()] = item;
+            ++count;
+        }
+        notEmpty.notify_one();
+        return didDrop;
+    }
+
+    /**
+     * @brief 阻塞入队，队列已满时等待消费者取走数据，不丢弃任何元素
+     * @return 队列被关闭时返回false（元素没有入队）
+     */
+    bool pushWait(const T& item) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this] { return count < buffer.size() || closed; });
+            if (closed) {
+                return false;
+            }
+            buffer[(head + count) % buffer.size()] = item;
+            ++count;
+        }
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 阻塞出队，直到有数据或队列被关闭
+     * @return 队列关闭且为空时返回false
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return count > 0 || closed; });
+        return takeLocked(item);
+    }
+
+    /**
+     * @brief 带超时的出队
+     * @return 超时或队列关闭时返回false
+     */
+    template <typename Rep, typename Period>
+    bool popFor(T& item, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait_for(lock, timeout, [this] { return count > 0 || closed; });
+        return takeLocked(item);
+    }
+
+    // 非阻塞出队
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return takeLocked(item);
+    }
+
+    // 关闭队列，唤醒所有等待的消费者和生产者
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    // 清空并重新打开队列；newCapacity不为0时同时调整容量
+    void reset(size_t newCapacity = 0) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = T();
+        }
+        if (newCapacity > 0 && newCapacity != buffer.size()) {
+            buffer.resize(newCapacity);
+        }
+        head = 0;
+        count = 0;
+        closed = false;
+        lock.unlock();
+        notFull.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return buffer.size();
+    }
+
+    // 因队列满而被丢弃的元素总数
+    size_t droppedCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return dropped;
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t head;
+    size_t count;
+    bool closed;
+    size_t dropped;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+
+    bool takeLocked(T& item) {
+        if (count == 0) {
+            return false;
+        }
+        item = buffer[head];
+        buffer[head] = T();
+        head = (head + 1) % buffer.size();
+        --count;
+        notFull.notify_one();
+        return true;
+    }
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,36 @@
+#ifndef FILE_SYSTEM_H
+#define FILE_SYSTEM_H
+
+#include <string>
+#include <cerrno>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+/**
+ * @brief 逐级创建目录，不经过shell
+ *
+ * @param path 目录路径（以'/'分隔）
+ * @return 目录已存在或创建成功时返回true
+ */
+inline bool ensureDirectory(const std::string& path) {
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+        const std::string prefix = path.substr(0, pos);
+#ifdef _WIN32
+        int result = _mkdir(prefix.c_str());
+#else
+        int result = mkdir(prefix.c_str(), 0755);
+#endif
+        if (result != 0 && errno != EEXIST) {
+            return false;
+        }
+        if (pos == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+#endif // FILE_SYSTEM_H
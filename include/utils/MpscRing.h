@@ -0,0 +1,91 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief 有界无锁环形队列（多生产者、单消费者）
+ *
+ * 每个槽位带一个序号：生产者用CAS抢占写入位置，写完后推进槽位序号，消费者看到序号推进后读取；
+ * 入队出队都不加锁，也不产生堆分配（元素在构造时预先创建，之后原地赋值）。
+ * 单生产者时同样适用（SPSC）。消费者独占队头，生产者无法丢弃最旧的元素，
+ * 因此队列满时tryPush()直接失败，由调用方计数。容量向上取整为2的幂。
+ */
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity)
+        : slots(roundUpPowerOfTwo(capacity)), mask(slots.size() - 1), tail(0), head(0) {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 入队（任意线程），队列已满时返回false
+    bool tryPush(const T& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[position & mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // 消费者还没有取走这个槽位上一轮的元素
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 出队（只由消费者线程调用），队列为空时返回false
+    bool tryPop(T& item) {
+        Slot& slot = slots[head & mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != head + 1) {
+            return false;
+        }
+        item = slot.item;
+        slot.sequence.store(head + slots.size(), std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    // 是否有可以出队的元素（只由消费者线程调用）
+    bool empty() const {
+        return slots[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+
+        Slot() : sequence(0) {}
+        Slot(const Slot& other) : sequence(other.sequence.load()), item(other.item) {}
+    };
+
+    std::vector<Slot> slots;
+    size_t mask;
+    std::atomic<size_t> tail;   // 下一个写入位置（生产者共享）
+    size_t head;                // 下一个读取位置（只由消费者使用）
+
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+};
+
+#endif // MPSC_RING_H
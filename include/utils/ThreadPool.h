@@ -0,0 +1,128 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @brief 固定线程数的并行执行池
+ *
+ * 只提供parallelFor：把0..count-1的任务分给工作线程和调用线程共同执行，
+ * 全部完成后返回。工作线程在构造时创建，之后在调用之间复用。
+ * 同一时刻只应有一个线程调用parallelFor。
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount)
+        : job(nullptr), jobCount(0), nextIndex(0), pending(0), activeWorkers(0), generation(0),
+          stopping(false) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    // 并行执行fn(0) ... fn(count-1)，阻塞直到全部完成
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) {
+            return;
+        }
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            nextIndex = 0;
+            pending = count;
+            ++generation;
+        }
+        wake.notify_all();
+
+        // 调用线程也参与执行
+        runTasks(fn, count);
+
+        // 等待所有任务完成，并且没有工作线程还持有本次任务
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0 && activeWorkers == 0; });
+        job = nullptr;
+    }
+
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* job;
+    size_t jobCount;
+    std::atomic<size_t> nextIndex;
+    size_t pending;
+    size_t activeWorkers;
+    unsigned long generation;
+    bool stopping;
+
+    // 领取并执行任务，直到没有剩余任务
+    void runTasks(const std::function<void(size_t)>& fn, size_t count) {
+        size_t finished = 0;
+        for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+            fn(i);
+            ++finished;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        pending -= finished;
+        if (pending == 0) {
+            done.notify_all();
+        }
+    }
+
+    void workerLoop() {
+        unsigned long seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* current = nullptr;
+            size_t count = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen] { return stopping || (job != nullptr && generation != seen); });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                current = job;
+                count = jobCount;
+                ++activeWorkers;
+            }
+            runTasks(*current, count);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --activeWorkers;
+            }
+            done.notify_all();
+        }
+    }
+};
+
+#endif // THREAD_POOL_H
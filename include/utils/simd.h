@@ -0,0 +1,18 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// SIMD指令集检测
+// 启用AVX2需要在编译时打开（CMake选项 AICOMPANION_ENABLE_AVX2），
+// x86-64平台默认具备SSE2；其他平台（如ESP32）只使用标量实现
+
+#if defined(__AVX2__)
+#define AICOMPANION_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AICOMPANION_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#endif // SIMD_H
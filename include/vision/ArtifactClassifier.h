@@ -0,0 +1,91 @@
+#ifndef ARTIFACT_CLASSIFIER_H
+#define ARTIFACT_CLASSIFIER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "vision/InferenceBackend.h"
+#include "vision/model_utils.h"
+
+// 一个检测框的文物分类结果
+struct ArtifactPrediction {
+    int classId;     // 分类器类别，-1表示不是文物（低于阈值、背景类或超出每帧数量上限）
+    float score;
+
+    ArtifactPrediction() : classId(-1), score(0.0f) {}
+};
+
+/**
+ * @brief 第二阶段的文物分类器
+ *
+ * 从检测框裁剪出区域（向外扩展一圈上下文），缩放到分类器的输入尺寸后按ImageNet均值/方差归一化，
+ * 一帧中所有裁剪写入同一个预先分配的 N×3×S×S 裁剪张量，一次前向推理完成分类。
+ * 检测模型的输入（已信箱缩放、RGB、[0,1]的float张量）可用时优先从中裁剪，不再缩放原图；
+ * 目标在模型输入中太小（需要放大一倍以上）时才从原图裁剪，保留细节。
+ * 模型不支持批量输入时逐个裁剪推理。一个实例只由一个线程使用。
+ */
+class ArtifactClassifier {
+public:
+    // 每帧最多分类的检测框数量（裁剪张量按此分配）
+    static const int kMaxCrops = 16;
+
+    ArtifactClassifier();
+
+    // 用指定的推理后端加载分类模型，labelsPath为每行一个类别名称的文件；
+    // 类别名为"background"或"none"的类别表示不是文物
+    bool load(const std::string& modelPath, const std::string& labelsPath,
+              const std::string& backendName, int inputSize);
+
+    void unload();
+    bool isLoaded() const { return backend != nullptr; }
+
+    const std::vector<std::string>& classNames() const { return names; }
+
+    // 低于该分数的结果视为不是文物（默认0.5）
+    void setMinScore(float score) { minScore = score; }
+
+    /**
+     * @brief 对一帧中的检测框分类
+     *
+     * @param frame 原图（8位BGR）
+     * @param modelInput 检测模型的 1×3×H×W float输入张量，不可用时为nullptr
+     * @param letterbox modelInput的信箱缩放参数
+     * @param boxes 原图坐标的检测框，只分类前kMaxCrops个
+     * @param predictions 与boxes一一对应的结果
+     * @return 推理失败时返回false（predictions全部为不是文物）
+     */
+    bool classify(const cv::Mat& frame, const cv::Mat* modelInput, const LetterboxInfo& letterbox,
+                  const std::vector<cv::Rect>& boxes, std::vector<ArtifactPrediction>& predictions);
+
+    // 从模型输入和原图裁剪的次数（用于调优）
+    size_t modelInputCropCount() const { return modelInputCrops; }
+    size_t frameCropCount() const { return frameCrops; }
+
+private:
+    std::unique_ptr<InferenceBackend> backend;
+    std::vector<std::string> names;
+    std::vector<char> background;      // 各类别是否为背景类
+    int size;
+    float minScore;
+    bool batchSupported;
+
+    cv::Mat cropTensor;                // kMaxCrops×3×S×S，加载时分配一次
+    std::vector<cv::Mat> outputs;
+    cv::Mat resized;                   // 从原图裁剪时的缩放缓冲区
+    std::vector<int> x0;               // 从模型输入裁剪时的水平插值表
+    std::vector<float> xWeight;
+    std::vector<float> probabilities;
+    std::vector<int> cropOwners;       // 各裁剪对应的检测框下标
+    size_t modelInputCrops;
+    size_t frameCrops;
+
+    // 把一个裁剪写入裁剪张量的第index个位置
+    void cropFromModelInput(const cv::Mat& modelInput, const cv::Rect2f& region, int index);
+    void cropFromFrame(const cv::Mat& frame, const cv::Rect& region, int index);
+
+    // 把输出中第row个裁剪的分数（logits或概率，量化输出先反量化）转换为类别和分数
+    ArtifactPrediction decode(const cv::Mat& output, int row);
+};
+
+#endif // ARTIFACT_CLASSIFIER_H
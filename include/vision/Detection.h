@@ -0,0 +1,167 @@
+#ifndef DETECTION_H
+#define DETECTION_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#ifdef ESP32
+// ESP32环境没有OpenCV，检测框使用与cv::Rect相同的字段
+struct DetectionRect {
+    int x;
+    int y;
+    int width;
+    int height;
+
+    DetectionRect() : x(0), y(0), width(0), height(0) {}
+};
+#else
+#include <opencv2/opencv.hpp>
+typedef cv::Rect DetectionRect;
+#endif
+
+/**
+ * @brief 一个检测结果
+ *
+ * 标签以驻留ID表示（见LabelTable），发布和读取结果时不产生字符串分配。
+ * 模拟模式和文物识别产生的结果没有模型类别（classId为-1），模拟结果没有检测框（box为空）。
+ */
+struct Detection {
+    DetectionRect box;   // 原图坐标
+    float score;
+    int classId;         // 模型类别ID
+    int labelId;         // 驻留的标签ID
+    int trackId;         // 跟踪ID，-1表示没有经过跟踪器
+    std::chrono::steady_clock::time_point timestamp;  // 所在帧的采集时间
+
+    Detection() : score(0.0f), classId(-1), labelId(-1), trackId(-1) {}
+};
+
+/**
+ * @brief 标签驻留表：每个标签字符串只保存一份，以整数ID引用
+ *
+ * ID只增不减，name()返回的引用在表的生命周期内一直有效。可以被多个线程同时使用。
+ */
+class LabelTable {
+public:
+    // 返回标签的ID，第一次出现时分配新ID
+    int intern(const std::string& label);
+
+    // 已驻留标签的ID，不存在时返回-1（不会新增）
+    int find(const std::string& label) const;
+
+    // ID对应的标签，未知ID返回空字符串
+    const std::string& name(int labelId) const;
+
+private:
+    mutable std::mutex mutex;
+    std::deque<std::string> names;   // deque在末尾追加时已有元素的地址不变
+    std::map<std::string, int> ids;
+};
+
+/**
+ * @brief 一次发布的检测结果
+ */
+struct DetectionFrame {
+    unsigned long sequence;   // 发布序号，每次发布递增
+    unsigned long frameId;
+    std::chrono::steady_clock::time_point timestamp;
+    std::vector<Detection> detections;
+
+    DetectionFrame() : sequence(0), frameId(0) {}
+};
+
+// 每个结果缓冲区预留的检测结果容量，一帧的检测结果不超过它时写入不会扩容
+const size_t kReservedDetections = 64;
+
+// 结果槽位中的一个缓冲区，readers为正在持有它的视图数量
+struct DetectionBuffer {
+    DetectionFrame frame;
+    std::atomic<int> readers;
+
+    DetectionBuffer() : readers(0) {
+        frame.detections.reserve(kReservedDetections);
+    }
+};
+
+/**
+ * @brief 检测结果的只读视图
+ *
+ * 持有视图期间对应的缓冲区不会被写入方复用；复制视图只增加引用计数，
+ * 不复制检测结果，也不分配内存。
+ */
+class DetectionView {
+public:
+    typedef std::vector<Detection>::const_iterator const_iterator;
+
+    DetectionView() {}
+    DetectionView(const DetectionView& other);
+    DetectionView& operator=(const DetectionView& other);
+    ~DetectionView();
+
+    bool empty() const { return detections().empty(); }
+    size_t size() const { return detections().size(); }
+    const Detection& operator[](size_t index) const { return detections()[index]; }
+    const_iterator begin() const { return detections().begin(); }
+    const_iterator end() const { return detections().end(); }
+
+    // 发布序号，没有结果时为0
+    unsigned long sequence() const { return buffer ? buffer->frame.sequence : 0; }
+
+    // 结果所在帧的编号和采集时间
+    unsigned long frameId() const { return buffer ? buffer->frame.frameId : 0; }
+    std::chrono::steady_clock::time_point timestamp() const {
+        return buffer ? buffer->frame.timestamp : std::chrono::steady_clock::time_point();
+    }
+
+private:
+    friend class DetectionResultSlot;
+
+    // 缓冲区的生命周期由shared_ptr保证，是否可以被写入方复用由readers计数决定
+    std::shared_ptr<DetectionBuffer> buffer;
+
+    explicit DetectionView(const std::shared_ptr<DetectionBuffer>& buffer);
+    const std::vector<Detection>& detections() const;
+};
+
+/**
+ * @brief 单写多读的检测结果槽位
+ *
+ * 写入方在一个没有被发布、也没有被读取方持有的缓冲区中原地写入结果（容量在帧之间复用），
+ * 写完后发布，替换读取方看到的最新结果。预先准备三个缓冲区：一个已发布、一个正在写入、
+ * 一个留给还持有上一次视图的读取方；读取方长时间持有视图导致缓冲区不够时才新增一个。
+ */
+class DetectionResultSlot {
+public:
+    DetectionResultSlot();
+
+    // 取出一个可写入的缓冲区（只由写入线程调用，每次发布前调用一次）
+    DetectionFrame& beginWrite();
+
+    // 发布beginWrite()取出的缓冲区
+    void publish();
+
+    // 最新发布的结果
+    DetectionView read() const;
+
+    // 清空已发布的结果
+    void clear();
+
+    // 当前的缓冲区数量（稳态下保持不变）
+    size_t bufferCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<DetectionBuffer> > buffers;
+    std::shared_ptr<DetectionBuffer> latest;
+    size_t writing;
+    unsigned long sequence;
+};
+
+#endif // DETECTION_H
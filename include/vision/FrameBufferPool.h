@@ -0,0 +1,121 @@
+#ifndef FRAME_BUFFER_POOL_H
+#define FRAME_BUFFER_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include "vision/model_utils.h"
+
+// 批量推理时多帧共享的一组输出张量
+struct BatchOutputSet {
+    std::vector<cv::Mat> outputs;
+    std::atomic<int> refs;   // 仍在使用这组输出的帧数
+
+    BatchOutputSet() : refs(0) {}
+};
+
+// 流水线中流转的一帧，所有缓冲区在帧之间复用
+struct FrameSlot {
+    unsigned long frameId;
+    int cameraId;
+    std::chrono::steady_clock::time_point captureTime;
+
+    cv::Mat frame;                  // 采集缓冲区
+    cv::Mat blob;                   // 1×3×H×W 模型输入张量
+    LetterboxInfo letterbox;        // 预处理使用的信箱缩放参数
+    std::vector<cv::Mat> outputs;   // 逐帧推理的输出张量
+
+    // 批量推理时使用共享输出，batchIndex为本帧在批次中的位置
+    BatchOutputSet* batchOutputs;
+    int batchIndex;
+    bool inferenceOk;
+    bool runDetector;   // false表示本帧只由跟踪器推进，不做预处理和推理
+
+    // 级联模式：预处理只为筛选模型准备输入，需要完整模型时推理线程再生成blob
+    bool cascadeScreen;             // 先经过筛选模型
+    bool fullInputReady;            // blob中已是完整模型的输入
+    cv::Mat screenBlob;             // 筛选模型的输入张量（与完整模型输入不同时使用）
+    LetterboxInfo screenLetterbox;
+
+    // 分块推理在推理阶段就完成了解码和跨切片合并，结果直接存放在这里
+    bool predecoded;
+    std::vector<cv::Rect> boxes;
+    std::vector<float> confidences;
+    std::vector<int> classIds;
+
+    // 各阶段耗时（毫秒），启用延迟统计时由后处理线程汇总
+    double captureMs;
+    double preprocessMs;
+    double inferenceMs;
+
+    FrameSlot() : frameId(0), cameraId(0), batchOutputs(nullptr), batchIndex(0), inferenceOk(false),
+                  runDetector(true), cascadeScreen(false), fullInputReady(true), predecoded(false),
+                  captureMs(0.0), preprocessMs(0.0), inferenceMs(0.0) {
+        letterbox.scale = 1.0f;
+        letterbox.padX = 0;
+        letterbox.padY = 0;
+        letterbox.inputWidth = 0;
+        letterbox.inputHeight = 0;
+        screenLetterbox = letterbox;
+    }
+
+    // 本帧实际应解码的输出
+    const std::vector<cv::Mat>& inferenceOutputs() const {
+        return batchOutputs ? batchOutputs->outputs : outputs;
+    }
+};
+
+/**
+ * @brief 视觉流水线的帧缓冲池
+ *
+ * 预先分配固定数量的帧槽位，每个槽位持有自己的采集图像、输入张量和输出张量，
+ * 稳态下各阶段只在槽位之间传递指针，不再产生堆分配。
+ * allocationCount()统计缓冲区（重新）分配的次数，稳态下应保持不变。
+ */
+class FrameBufferPool {
+public:
+    FrameBufferPool();
+    ~FrameBufferPool();
+
+    // 按槽位数量预分配缓冲区（仅在流水线停止时调用）
+    void configure(size_t slotCount, const cv::Size& frameSize, const cv::Size& inputSize);
+
+    // 取出一个空闲槽位，池已耗尽时返回nullptr
+    FrameSlot* acquire();
+
+    // 归还槽位（同时释放其引用的批量输出）
+    void release(FrameSlot* slot);
+
+    // 取出一组空闲的批量输出张量，并登记将共享它的帧数
+    BatchOutputSet* acquireBatchOutputs(int users);
+
+    // 确保Mat具有指定形状和类型，需要重新分配时计数（形状用数组传入，检查时不构造临时对象）
+    void ensureMat(cv::Mat& mat, int rows, int cols, int type);
+    void ensureMat(cv::Mat& mat, int dims, const int* shape, int type);
+
+    // 记录一次池外发生的缓冲区分配（例如推理输出张量首次创建）
+    void noteAllocation();
+
+    // 缓冲区分配次数
+    size_t allocationCount() const;
+
+    // 当前空闲槽位数量
+    size_t freeCount() const;
+
+    // 槽位总数
+    size_t slotCount() const;
+
+private:
+    std::vector<FrameSlot*> slots;
+    std::vector<FrameSlot*> freeSlots;
+    std::vector<BatchOutputSet*> batchSets;
+    mutable std::mutex mutex;
+    std::atomic<size_t> allocations;
+
+    void clear();
+};
+
+#endif // FRAME_BUFFER_POOL_H
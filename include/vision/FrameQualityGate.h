@@ -0,0 +1,66 @@
+#ifndef FRAME_QUALITY_GATE_H
+#define FRAME_QUALITY_GATE_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief 帧质量门控参数
+ */
+struct FrameQualityGateConfig {
+    int thumbWidth;        // 缩小后的宽度（高度按宽高比计算）
+    float minSharpness;    // 拉普拉斯响应方差的下限，低于时视为模糊
+    float minLuma;         // 平均亮度下限（0-255），低于时视为欠曝
+    float maxLuma;         // 平均亮度上限（0-255），高于时视为过曝
+    int maxRejectMs;       // 连续拒绝的最长时间，超过后放行一帧，检测不会完全停下
+
+    FrameQualityGateConfig()
+        : thumbWidth(320), minSharpness(40.0f), minLuma(35.0f), maxLuma(225.0f), maxRejectMs(1000) {}
+};
+
+// 一帧的质量评分
+struct FrameQualityScores {
+    float sharpness;   // 缩小后灰度图的拉普拉斯响应方差，越大越清晰
+    float luma;        // 平均亮度（0-255）
+    bool admitted;     // 是否放行推理
+
+    FrameQualityScores() : sharpness(0.0f), luma(0.0f), admitted(true) {}
+};
+
+/**
+ * @brief 推理前的帧质量门控
+ *
+ * 把帧缩小为灰度图，计算4邻域拉普拉斯响应的方差（清晰度）和平均亮度。行走或手抖造成的
+ * 运动模糊帧、过暗或过曝的帧不值得一次完整的前向推理，检测结果也不可靠，直接拒绝；
+ * 连续拒绝超过maxRejectMs时放行一帧，保证最低的检测频率。
+ * 拉普拉斯和亮度统计在AVX2/SSE2下向量化，其他平台使用标量实现。每个摄像头使用一个独立的实例。
+ */
+class FrameQualityGate {
+public:
+    explicit FrameQualityGate(const FrameQualityGateConfig& config = FrameQualityGateConfig());
+
+    // 评估一帧，返回的评分中admitted为false时这一帧不需要推理
+    FrameQualityScores evaluate(const cv::Mat& frame, std::chrono::steady_clock::time_point now);
+
+    void setConfig(const FrameQualityGateConfig& config);
+
+    // 最近一次评估的评分（用于调参）
+    const FrameQualityScores& lastScores() const { return scores; }
+
+private:
+    FrameQualityGateConfig config;
+    cv::Mat thumb;                  // 缩小后的图像（复用）
+    std::vector<uint8_t> gray;      // 缩小后的灰度图
+    FrameQualityScores scores;
+    bool started;                   // 已开始计时（第一帧时开始）
+    std::chrono::steady_clock::time_point lastAdmitted;
+
+    void computeGray(const cv::Mat& frame);
+};
+
+// 灰度图（width×height，行连续）的拉普拉斯响应方差和平均亮度（边缘一圈像素不计入方差）
+void computeSharpnessAndLuma(const uint8_t* gray, int width, int height, float& sharpness, float& luma);
+
+#endif // FRAME_QUALITY_GATE_H
@@ -0,0 +1,111 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include "utils/BoundedQueue.h"
+
+/**
+ * @brief 最近帧的环形缓冲区 + 后台JPEG编码线程
+ *
+ * 采集线程把每一帧复制到预先分配的环形缓冲区中；保存快照或事件片段时只把缓冲区交给编码线程，
+ * JPEG编码和写文件都在编码线程中进行，采集和推理线程不会等待磁盘I/O。
+ * 已交给编码线程的缓冲区不会被覆盖：下一次写入该位置时换一块新的缓冲区。
+ * 不保留最近帧时（默认），采集线程只在有等待中的快照或片段时才复制帧，平时不做任何复制。
+ *
+ * 事件片段包含事件帧及之前的preEventFrames帧，以及之后采集到的postEventFrames帧，
+ * 以编号的JPEG序列写入指定目录。编码队列积压过多时丢弃最旧的任务，不阻塞调用方。
+ */
+class FrameRecorder {
+public:
+    FrameRecorder();
+    ~FrameRecorder();
+
+    // 设置事件前保留的帧数和事件后录制的帧数（环形缓冲区另外预留几帧覆盖检测延迟），
+    // 同时清空缓冲区并取消尚未完成的片段
+    void configure(size_t preEventFrames, size_t postFrames);
+
+    // 是否在环形缓冲区中保留最近的帧（默认不保留）。不保留时快照保存下一帧，
+    // 片段从下一帧开始，只包含事件帧和之后的帧
+    void setRetainFrames(bool retain);
+
+    // 设置JPEG质量（1-100，默认90）
+    void setJpegQuality(int quality);
+
+    // 采集线程调用：把一帧复制到环形缓冲区，并交给等待后续帧的快照和片段；
+    // 不保留最近帧、也没有等待中的快照和片段时直接返回
+    void pushFrame(const cv::Mat& frame, unsigned long frameId,
+                   std::chrono::steady_clock::time_point timestamp);
+
+    // 保存最新一帧，还没有帧时返回false
+    bool requestSnapshot(const std::string& path);
+
+    // 保存eventFrameId前后的事件片段到directory（目录不存在时创建），eventFrameId为0时
+    // 以最新一帧为事件帧；还没有帧时返回false
+    bool requestClip(const std::string& directory, unsigned long eventFrameId);
+
+    // 取消等待后续帧的片段（已采集的部分照常写入）
+    void cancelPendingClips();
+
+    // 已写入的图像数量和因积压而丢弃的任务数量
+    size_t writtenCount() const;
+    size_t droppedCount() const;
+
+private:
+    struct RingEntry {
+        cv::Mat image;
+        unsigned long frameId;
+        std::chrono::steady_clock::time_point timestamp;
+        bool shared;   // 缓冲区已交给编码线程，下次写入时换一块新的
+
+        RingEntry() : frameId(0), shared(false) {}
+    };
+
+    struct PendingClip {
+        std::string directory;
+        size_t remaining;   // 还需要的事件后帧数
+        int nextIndex;      // 下一帧的文件编号
+    };
+
+    struct EncodeTask {
+        cv::Mat image;
+        std::string path;
+        std::string directory;   // 不为空时先创建目录
+    };
+
+    mutable std::mutex mutex;
+    std::vector<RingEntry> ring;
+    size_t nextSlot;
+    size_t frameCount;           // 环形缓冲区中的有效帧数
+    size_t postEventFrames;
+    std::vector<PendingClip> pendingClips;
+    std::vector<std::string> pendingSnapshots;   // 等待下一帧的快照路径
+    bool retainFrames;
+    std::atomic<bool> framesWanted;              // 采集线程需要复制帧（不加锁检查）
+
+    BoundedQueue<EncodeTask> tasks;
+    std::thread encoder;
+    bool encoderStarted;
+    std::atomic<int> jpegQuality;
+    std::atomic<size_t> written;
+
+    // 把环形缓冲区中的一帧交给编码线程（调用时已持有mutex）
+    void submitEntry(RingEntry& entry, const std::string& path, const std::string& directory);
+
+    // 提交任务，第一次提交时启动编码线程（调用时已持有mutex）
+    void enqueue(const EncodeTask& task);
+
+    // 根据是否保留帧和等待中的请求更新framesWanted（调用时已持有mutex）
+    void updateFramesWanted();
+
+    // 编码线程
+    void encodeLoop();
+};
+
+#endif // FRAME_RECORDER_H
@@ -0,0 +1,52 @@
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief 视觉流水线的帧来源
+ *
+ * 采集线程逐帧调用read()，图像写入调用方复用的缓冲区（尺寸不变时不重新分配）。
+ * 除模拟摄像头外，还可以回放视频文件、图像目录和原始YUV文件，
+ * 便于离线复现检测吞吐和精度。一个实例只由一个线程调用。
+ */
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+
+    // 打开来源，失败时返回false
+    virtual bool open() = 0;
+
+    // 读取下一帧，没有更多帧（或读取失败）时返回false
+    virtual bool read(cv::Mat& frame) = 0;
+
+    // 来源的描述，用于日志
+    virtual std::string description() const = 0;
+
+    // 来源自身的帧率，未知时返回0（按采集帧率设置的节拍回放）
+    virtual double frameRate() const { return 0.0; }
+
+    // 实时来源（摄像头）的read()本身就按硬件节拍阻塞，不需要再控制回放节拍
+    virtual bool isLive() const { return false; }
+
+    // 是否已经读完（实时来源和模拟摄像头永远不会读完）
+    virtual bool finished() const { return false; }
+};
+
+/**
+ * @brief 按描述创建帧来源
+ *
+ * 支持的描述：
+ *   - 空字符串或"synthetic"：模拟摄像头（固定尺寸的空白图像）
+ *   - "camera:N"：编号为N的本地摄像头
+ *   - 目录路径：按文件名顺序回放其中的jpg/jpeg/png/bmp图像
+ *   - "路径.yuv:宽x高[:i420|nv12|nv21|yuyv]"：原始YUV文件，格式默认为i420
+ *   - 其他路径：视频文件
+ * 描述无法识别时返回空。返回的来源尚未打开。
+ */
+std::unique_ptr<FrameSource> createFrameSource(const std::string& spec);
+
+#endif // FRAME_SOURCE_H
@@ -0,0 +1,92 @@
+#ifndef INFERENCE_BACKEND_H
+#define INFERENCE_BACKEND_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "vision/model_utils.h"
+
+/**
+ * @brief 推理后端接口
+ *
+ * 输入为 N×3×H×W 的张量（与预处理内核的输出一致），元素类型由inputDepth()给出：
+ * 一般为float，全整型量化模型为uint8/int8。输出写入调用方复用的张量列表，形状
+ * 不变时实现不应重新分配；量化模型的输出可以是CV_8U/CV_8S，由解码器按
+ * outputQuantization()反量化。一个实例只由一个线程调用。
+ */
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() {}
+
+    // 后端名称，与createInferenceBackend()接受的名称一致
+    virtual std::string name() const = 0;
+
+    // 加载模型，失败时返回false
+    virtual bool load(const std::string& modelPath) = 0;
+
+    // 执行一次前向推理
+    virtual bool forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) = 0;
+
+    // 是否支持N大于1的批量输入（不支持时调用方逐帧推理）
+    virtual bool supportsBatch() const { return true; }
+
+    // 输入张量的元素类型：CV_32F，或全整型量化模型的CV_8U/CV_8S
+    virtual int inputDepth() const { return CV_32F; }
+
+    // 量化输入的参数（inputDepth()不是CV_32F时有效）
+    virtual QuantizationParams inputQuantization() const { return QuantizationParams(); }
+
+    // 第index个输出的量化参数（该输出为CV_8U/CV_8S时有效）
+    virtual QuantizationParams outputQuantization(size_t index) const {
+        (void)index;
+        return QuantizationParams();
+    }
+
+    // 输出坐标是否归一化到[0,1]（解码时需要乘以模型输入尺寸）
+    virtual bool normalizedBoxes() const { return false; }
+
+    // 设置网络缓存的路径前缀（不含扩展名），在load()之前调用。能序列化优化后网络的后端
+    // 优先从缓存加载，跳过图优化；没有缓存时在加载后写入。为空时不使用缓存
+    virtual void setCachePrefix(const std::string& prefix) { (void)prefix; }
+};
+
+// 按后端的输入类型创建一个填充为value（[0,1]的实数值）的输入张量
+cv::Mat makeBackendInput(const InferenceBackend& backend, const std::vector<int>& shape, float value);
+
+/**
+ * @brief 一个后端在加载时的测速结果
+ */
+struct BackendBenchmark {
+    std::string name;
+    bool loaded;
+    double medianMs;   // 预热后多次前向推理的中位耗时
+    bool cached;       // 结果来自上一次启动时缓存的测速记录
+};
+
+// 模型文件内容的哈希（16位十六进制），用作网络缓存的键；文件无法读取时返回空
+std::string modelCacheKey(const std::string& modelPath);
+
+// 按名称创建后端："opencv-cpu"、"opencv-fp16"、"onnxruntime"、"tflite"；未编译或未知时返回空
+std::unique_ptr<InferenceBackend> createInferenceBackend(const std::string& name);
+
+// 当前构建中可用的后端名称（按优先顺序）
+std::vector<std::string> availableInferenceBackends();
+
+/**
+ * @brief 加载模型并选择后端
+ *
+ * preferred为空或"auto"时，在实际模型上对每个可用后端预热一次、测速若干次，
+ * 选择中位耗时最短的后端；指定了后端名称时直接使用，加载失败再退回自动选择。
+ * inputShape为测速输入的形状，results返回各后端的测速结果。
+ * cacheDir不为空时，测速结果和各后端的优化网络按模型哈希 + 后端名称缓存在该目录中，
+ * 同一模型再次启动时直接使用上次选出的后端，不再逐个测速。
+ */
+std::unique_ptr<InferenceBackend> selectInferenceBackend(const std::string& modelPath,
+                                                         const std::string& preferred,
+                                                         const std::vector<int>& inputShape,
+                                                         int benchmarkRuns,
+                                                         const std::string& cacheDir,
+                                                         std::vector<BackendBenchmark>& results);
+
+#endif // INFERENCE_BACKEND_H
@@ -0,0 +1,154 @@
+#ifndef INSCRIPTION_READER_H
+#define INSCRIPTION_READER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include "utils/BoundedQueue.h"
+#include "vision/InferenceBackend.h"
+
+// 需要识别文字的一个检测框
+struct InscriptionRegion {
+    int trackId;
+    cv::Rect box;   // 原图坐标
+};
+
+/**
+ * @brief 碑文、书法作品的文字检测与识别
+ *
+ * 后处理线程只把需要识别的检测框从原图中复制出来交给工作线程，识别在工作线程中进行，
+ * 不占用视觉流水线的时间。工作线程先按墨迹的投影找出文字列（竖排，从右到左）或文字行（横排），
+ * 竖排的列再按字切开、从左到右排成一行；一帧中所有文字行写入同一个预先分配的 N×3×H×W 张量，
+ * 一次前向推理后按CTC贪心解码（识别模型为CRNN/PP-OCR识别模型一类，类别0为空白）。
+ *
+ * 结果按（摄像头, 跟踪ID）缓存：同一块碑在画面中期间只识别一次，置信度不高时隔一段时间
+ * 换一帧重试，最多重试几次；跟踪结束后结果随之删除。
+ */
+class InscriptionReader {
+public:
+    // 每帧最多识别的文字行数（行张量按此分配）
+    static const int kMaxLines = 32;
+
+    InscriptionReader();
+    ~InscriptionReader();
+
+    // 用指定的推理后端加载识别模型，dictPath为每行一个字符的字典文件（不含空白类别），
+    // 识别模型的输入为 N×3×inputHeight×inputWidth；加载成功后启动工作线程
+    bool load(const std::string& modelPath, const std::string& dictPath, const std::string& backendName,
+              int inputHeight, int inputWidth);
+
+    // 停止工作线程并释放模型（未完成的识别任务被丢弃）
+    void unload();
+    bool isLoaded() const { return loaded; }
+
+    /**
+     * @brief 提交一帧中的碑文、书法作品区域（后处理线程调用）
+     *
+     * 已有可靠结果、正在识别或刚识别过的跟踪目标跳过，其余区域从frame中复制出来，
+     * 作为一个任务交给工作线程（调用返回后frame可以被复用）。
+     * @return 交给工作线程的区域数量
+     */
+    size_t submit(int cameraId, const cv::Mat& frame, const std::vector<InscriptionRegion>& regions,
+                  std::chrono::steady_clock::time_point now);
+
+    // 删除指定摄像头中不在activeTrackIds里的跟踪目标的结果
+    void retainTracks(int cameraId, const std::vector<int>& activeTrackIds);
+
+    // 跟踪目标识别出的文字和置信度（各字符概率的平均值），还没有识别出文字时返回false
+    bool getText(int cameraId, int trackId, std::string& text, float& confidence) const;
+
+    // 清空所有结果
+    void clear();
+
+    // 已识别的文字行数和因积压而丢弃的任务数（用于调优）
+    size_t recognizedLineCount() const { return recognizedLines; }
+    size_t droppedTaskCount() const { return tasks.droppedCount(); }
+
+private:
+    struct Crop {
+        int trackId;
+        cv::Mat image;   // 复制出的区域（8位BGR）
+    };
+
+    struct ReadTask {
+        int cameraId;
+        std::vector<Crop> crops;
+
+        ReadTask() : cameraId(0) {}
+    };
+
+    struct TrackText {
+        std::string text;
+        float confidence;
+        int attempts;
+        bool pending;    // 已交给工作线程，还没有结果
+        std::chrono::steady_clock::time_point lastAttempt;
+
+        TrackText() : confidence(0.0f), attempts(0), pending(false) {}
+    };
+
+    // 一行文字：由crop中的若干块（竖排时为各个字）从左到右拼成
+    struct TextLine {
+        int owner;                       // 所属裁剪在任务中的下标
+        std::vector<cv::Rect> pieces;
+    };
+
+    std::unique_ptr<InferenceBackend> backend;
+    std::vector<std::string> dictionary;   // 类别i（i≥1）对应dictionary[i-1]
+    int spaceClass;                        // 空格类别（PP-OCR字典追加的空格），没有时为-1
+    int height;
+    int width;
+    bool batchSupported;
+    std::atomic<bool> loaded;
+
+    mutable std::mutex mutex;
+    std::map<std::pair<int, int>, TrackText> texts;   // (摄像头, 跟踪ID) → 识别结果
+    BoundedQueue<ReadTask> tasks;
+    std::thread worker;
+    std::atomic<size_t> recognizedLines;
+
+    // 以下只由工作线程使用，在任务之间复用
+    cv::Mat lineTensor;                  // kMaxLines×3×H×W，加载时分配一次
+    std::vector<cv::Mat> outputs;
+    cv::Mat gray;
+    cv::Mat binary;                      // Otsu二值化结果
+    cv::Mat lineImage;
+    cv::Mat resized;
+    std::vector<int> columnInk;
+    std::vector<int> rowInk;
+    std::vector<std::pair<int, int> > runs;
+    std::vector<std::pair<int, int> > pieceRuns;
+    std::vector<TextLine> lines;         // 前lineCount个有效，各行的pieces容量在任务之间复用
+    size_t lineCount;
+    std::vector<cv::Scalar> backgrounds; // 各裁剪的背景颜色
+    std::vector<float> step;             // 一个时间步的各类别分数
+    std::vector<std::string> cropTexts;
+    std::vector<float> cropScores;
+    std::vector<int> cropChars;
+
+    void readLoop();
+
+    // 识别一个任务中的所有区域，结果写入cropTexts、cropScores和cropChars
+    void read(const ReadTask& task);
+
+    // 找出一个裁剪中的文字行（按阅读顺序）追加到lines，返回背景颜色
+    cv::Scalar segmentLines(const cv::Mat& crop, int owner);
+
+    // 把一行文字缩放到识别模型的输入高度，写入行张量的第index个位置
+    void writeLine(const cv::Mat& crop, const TextLine& line, const cv::Scalar& background, int index);
+
+    // 对输出中第row行做CTC贪心解码，结果追加到所属裁剪
+    void decodeLine(const cv::Mat& output, int row, bool timeMajor, int owner);
+
+    // 结束一个任务中各区域的识别，保留置信度更高的结果
+    void finish(const ReadTask& task);
+};
+
+#endif // INSCRIPTION_READER_H
@@ -0,0 +1,88 @@
+#ifndef OBJECT_TRACKER_H
+#define OBJECT_TRACKER_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief 跟踪器参数
+ */
+struct ObjectTrackerConfig {
+    float iouThreshold;   // 检测框与预测框关联所需的最小IoU
+    int minHits;          // 连续命中多少次后确认为有效目标
+    int maxMisses;        // 连续多少次检测未命中后删除
+
+    ObjectTrackerConfig() : iouThreshold(0.3f), minHits(2), maxMisses(3) {}
+};
+
+/**
+ * @brief 一条跟踪轨迹的对外视图
+ */
+struct TrackedObject {
+    int trackId;      // 稳定的跟踪ID，在目标消失前保持不变
+    int classId;
+    float score;      // 最近一次命中时的置信度
+    cv::Rect box;     // 当前（预测或校正后）的检测框
+    int hits;         // 累计命中次数
+    int misses;       // 连续未命中的检测次数
+    bool confirmed;
+};
+
+/**
+ * @brief SORT风格的多目标跟踪器
+ *
+ * 每条轨迹用恒速卡尔曼滤波器（状态为中心点、面积、宽高比及其速度）预测检测框，
+ * 检测结果按IoU贪心关联到同类别的轨迹。检测器只需每隔几帧运行一次，
+ * 中间帧调用predict()推进轨迹，目标在画面中期间跟踪ID保持不变。
+ */
+class ObjectTracker {
+public:
+    explicit ObjectTracker(const ObjectTrackerConfig& config = ObjectTrackerConfig());
+
+    // 没有检测结果的帧：只按运动模型推进所有轨迹
+    void predict();
+
+    // 有检测结果的帧：推进轨迹后与检测框关联，更新、新建和删除轨迹
+    void update(const std::vector<cv::Rect>& boxes,
+                const std::vector<float>& scores,
+                const std::vector<int>& classIds);
+
+    // 当前所有已确认且未丢失的轨迹
+    void getActiveTracks(std::vector<TrackedObject>& tracks) const;
+
+    // 上一次更新是否有轨迹丢失（需要尽快重新检测）
+    bool hasLostTracks() const { return lostInLastUpdate; }
+
+    // 清除所有轨迹
+    void clear();
+
+    size_t trackCount() const { return tracks.size(); }
+
+private:
+    struct Track {
+        TrackedObject info;
+        cv::KalmanFilter kalman;
+        cv::Mat measurement;
+    };
+
+    ObjectTrackerConfig config;
+    std::vector<Track> tracks;
+    int nextTrackId;
+    bool lostInLastUpdate;
+
+    // 关联时复用的缓冲区
+    struct Candidate {
+        float iou;
+        int track;
+        int detection;
+    };
+    std::vector<Candidate> candidates;
+    std::vector<char> trackMatched;
+    std::vector<char> detectionMatched;
+
+    void initTrack(Track& track, const cv::Rect& box, int classId, float score);
+    void predictTrack(Track& track);
+    void correctTrack(Track& track, const cv::Rect& box);
+};
+
+#endif // OBJECT_TRACKER_H
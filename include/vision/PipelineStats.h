@@ -0,0 +1,56 @@
+#ifndef PIPELINE_STATS_H
+#define PIPELINE_STATS_H
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+// 视觉流水线中统计耗时的阶段，EndToEnd为从采集完成到结果发布的总延迟（含排队时间）
+enum class PipelineStage {
+    Capture,
+    Preprocess,
+    Inference,
+    Postprocess,
+    EndToEnd
+};
+
+const int kPipelineStageCount = 5;
+
+// 一个阶段的耗时统计（毫秒）
+struct StageLatency {
+    size_t count;
+    double meanMs;
+    double p50Ms;
+    double p95Ms;
+    double maxMs;
+
+    StageLatency() : count(0), meanMs(0.0), p50Ms(0.0), p95Ms(0.0), maxMs(0.0) {}
+};
+
+/**
+ * @brief 流水线各阶段的耗时记录
+ *
+ * 保存每一帧的原始样本，统计时再计算分位数，用于基准测试和性能分析；
+ * 样本数量随帧数增长，默认不启用（见VisionProcessor::setLatencyRecording）。
+ * 可以被多个线程同时使用。
+ */
+class PipelineStats {
+public:
+    // 记录一个样本
+    void record(PipelineStage stage, double ms);
+
+    // 计算一个阶段的统计结果
+    StageLatency summarize(PipelineStage stage) const;
+
+    // 清空所有样本
+    void reset();
+
+    // 阶段名称，用于报告
+    static const char* stageName(PipelineStage stage);
+
+private:
+    mutable std::mutex mutex;
+    std::vector<double> samples[kPipelineStageCount];
+};
+
+#endif // PIPELINE_STATS_H
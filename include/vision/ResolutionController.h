@@ -0,0 +1,95 @@
+#ifndef RESOLUTION_CONTROLLER_H
+#define RESOLUTION_CONTROLLER_H
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 自适应输入分辨率参数
+ */
+struct ResolutionControllerConfig {
+    float budgetMs;          // 每帧推理的延迟预算（毫秒）
+    float downscaleRatio;    // 平滑延迟超过预算的这一比例时降低一档
+    float upscaleRatio;      // 预计上一档的延迟低于预算的这一比例时升高一档
+    int switchFrames;        // 条件需要连续满足的帧数
+    int cooldownFrames;      // 切换后至少保持的帧数，之后才考虑升高分辨率
+    float highCpuLoad;       // 整机CPU占用超过该值（0-1）时不升高分辨率
+    float smoothing;         // 延迟指数平滑系数（0-1，越大越灵敏）
+
+    ResolutionControllerConfig()
+        : budgetMs(66.0f), downscaleRatio(1.0f), upscaleRatio(0.7f), switchFrames(5),
+          cooldownFrames(30), highCpuLoad(0.85f), smoothing(0.2f) {}
+};
+
+/**
+ * @brief 按每帧延迟预算在多档模型输入尺寸之间切换
+ *
+ * 每次推理后报告所用的输入尺寸和耗时：当前尺寸的平滑延迟连续若干帧超过预算时降低一档；
+ * 按面积从当前延迟推算出的上一档延迟连续若干帧低于预算的upscaleRatio、切换后已过冷却期
+ * 且CPU不繁忙时升高一档。降档阈值和升档阈值之间的间隔加上冷却期构成滞回，避免在两档之间来回切换。
+ * 不是线程安全的，由推理线程使用。
+ */
+class ResolutionController {
+public:
+    explicit ResolutionController(const ResolutionControllerConfig& config = ResolutionControllerConfig());
+
+    void setConfig(const ResolutionControllerConfig& config);
+    const ResolutionControllerConfig& getConfig() const { return config; }
+
+    // 设置可选的输入尺寸（排序去重）并从initialSize开始（不在列表中时从最大的一档开始），
+    // 同时清空延迟记录
+    void setSizes(const std::vector<int>& sizes, int initialSize);
+    const std::vector<int>& getSizes() const { return sizes; }
+
+    // 报告一次推理：inputSize为这一帧实际使用的尺寸，cpuLoad为整机CPU占用（未知时为负数）。
+    // 返回之后的帧应使用的输入尺寸
+    int update(int inputSize, double inferenceMs, float cpuLoad);
+
+    int currentSize() const;
+
+    // 当前尺寸的平滑推理延迟，还没有样本时为0
+    double smoothedLatencyMs() const;
+
+    // 累计切换次数
+    size_t switchCount() const { return switches; }
+
+private:
+    ResolutionControllerConfig config;
+    std::vector<int> sizes;        // 从小到大
+    size_t current;                // sizes中的下标
+    double smoothedMs;
+    bool hasSample;
+    bool skipNextSample;           // 切换后第一帧包含重新分配内存的开销，不计入
+    int framesSinceSwitch;
+    int overBudgetFrames;
+    int underBudgetFrames;
+    size_t switches;
+
+    void switchTo(size_t index);
+};
+
+/**
+ * @brief 整机CPU占用采样（读取/proc/stat，其他平台返回-1）
+ *
+ * 两次读取之间间隔太短时统计不稳定，sample()在间隔不足时返回上一次的结果，
+ * 因此可以每帧调用。
+ */
+class CpuLoadMonitor {
+public:
+    explicit CpuLoadMonitor(int minIntervalMs = 500);
+
+    // 距上一次采样以来的平均CPU占用（0-1），无法读取时返回-1
+    float sample();
+
+private:
+    std::chrono::milliseconds minInterval;
+    std::chrono::steady_clock::time_point lastSample;
+    uint64_t lastBusy;
+    uint64_t lastTotal;
+    bool hasBaseline;
+    float lastLoad;
+};
+
+#endif // RESOLUTION_CONTROLLER_H
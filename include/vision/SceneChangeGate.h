@@ -0,0 +1,63 @@
+#ifndef SCENE_CHANGE_GATE_H
+#define SCENE_CHANGE_GATE_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief 场景变化门控参数
+ */
+struct SceneChangeGateConfig {
+    int thumbWidth;            // 缩略图宽度
+    int thumbHeight;           // 缩略图高度
+    float diffThreshold;       // 平均绝对灰度差阈值（0-255）
+    float histogramThreshold;  // 灰度直方图L1距离阈值（0-2）
+    int maxStaleMs;            // 最长复用时间，超过后强制推理一次
+
+    SceneChangeGateConfig()
+        : thumbWidth(32), thumbHeight(24), diffThreshold(6.0f),
+          histogramThreshold(0.2f), maxStaleMs(2000) {}
+};
+
+/**
+ * @brief 推理前的场景变化门控
+ *
+ * 把帧缩小为灰度缩略图，与上一次推理时的参考缩略图比较帧差和直方图距离。
+ * 画面基本不变时门控不触发，调用方沿用上一次的检测结果；超过最长复用时间
+ * 后强制触发一次，避免结果无限期陈旧。每个摄像头使用一个独立的实例。
+ */
+class SceneChangeGate {
+public:
+    explicit SceneChangeGate(const SceneChangeGateConfig& config = SceneChangeGateConfig());
+
+    // 判断这一帧是否需要推理；返回true时当前帧成为新的参考帧
+    bool shouldInfer(const cv::Mat& frame, std::chrono::steady_clock::time_point now);
+
+    // 丢弃参考帧，下一帧必定触发推理
+    void reset();
+
+    void setConfig(const SceneChangeGateConfig& config);
+
+    // 最近一次比较的帧差和直方图距离（用于调参）
+    float lastDifference() const { return lastDiff; }
+    float lastHistogramDistance() const { return lastHistDistance; }
+
+private:
+    static const int kHistogramBins = 16;
+
+    SceneChangeGateConfig config;
+    cv::Mat thumb;                       // 缩小后的BGR缩略图（复用）
+    std::vector<uint8_t> current;        // 当前帧的灰度缩略图
+    std::vector<uint8_t> reference;      // 上一次推理时的灰度缩略图
+    float referenceHist[kHistogramBins];
+    bool hasReference;
+    std::chrono::steady_clock::time_point lastInference;
+    float lastDiff;
+    float lastHistDistance;
+
+    void computeThumbnail(const cv::Mat& frame);
+};
+
+#endif // SCENE_CHANGE_GATE_H
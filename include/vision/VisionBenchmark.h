@@ -0,0 +1,52 @@
+#ifndef VISION_BENCHMARK_H
+#define VISION_BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+// 视觉流水线基准测试的参数
+struct VisionBenchmarkOptions {
+    std::string source;        // 帧来源描述，见createFrameSource()
+    bool realTime;             // 按来源帧率回放（默认尽快回放，不丢帧）
+    std::string backend;       // 推理后端，为空时自动选择
+    bool sceneGate;            // 是否启用场景变化门控
+    bool qualityGate;          // 是否启用帧质量门控（默认阈值）
+    int detectionInterval;     // 检测间隔，0表示使用默认值
+    int batchSize;             // 批量推理帧数
+    std::string cascadeModel;  // 级联检测的筛选模型，为空时不使用级联
+    float latencyBudgetMs;     // 自适应输入分辨率的每帧推理预算，0表示固定输入尺寸
+    double maxSeconds;         // 最长运行时间，0表示直到来源读完（不会读完的来源默认10秒）
+
+    VisionBenchmarkOptions()
+        : realTime(false), sceneGate(true), qualityGate(false), detectionInterval(0), batchSize(1), latencyBudgetMs(0.0f),
+          maxSeconds(0.0) {}
+};
+
+/**
+ * @brief 用给定的帧来源运行视觉流水线，报告端到端帧率和各阶段延迟
+ *
+ * 等待模型加载（含预热）完成后才开始计时，来源读完且流水线中的帧全部处理完时结束。
+ * @return 进程退出码，帧来源或模型初始化失败时为非0
+ */
+int runVisionBenchmark(const VisionBenchmarkOptions& options);
+
+// NMS基准测试的参数
+struct NMSBenchmarkOptions {
+    std::vector<int> candidateCounts;  // 每组测试的候选框数量
+    int classCount;                    // 候选框的类别数
+    int repeats;                       // 新实现的重复次数（取平均）
+    unsigned int seed;                 // 随机数种子，相同种子生成相同的候选框
+
+    NMSBenchmarkOptions() : candidateCounts({1000, 10000, 25000}), classCount(80), repeats(20), seed(42) {}
+};
+
+/**
+ * @brief 比较原来的O(n²)贪心NMS与排序+位图的NMS
+ *
+ * 按种子生成随机候选框，分别测试不区分类别和按类别两种方式，报告两种实现的耗时，
+ * 并检查保留的框是否一致。
+ * @return 进程退出码，两种实现的结果不一致时为非0
+ */
+int runNMSBenchmark(const NMSBenchmarkOptions& options);
+
+#endif // VISION_BENCHMARK_H
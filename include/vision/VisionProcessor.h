@@ -3,6 +3,11 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include "vision/Detection.h"
+#include "vision/PipelineStats.h"
 
 #ifdef ESP32
 #include <tensorflow/lite/micro/kernels/all_ops_resolver.h>
@@ -13,8 +18,45 @@
 #else
 #include <opencv2/opencv.hpp>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <map>
+#include <memory>
+#include "utils/BoundedQueue.h"
+#include "utils/ThreadPool.h"
+#include "vision/FrameBufferPool.h"
+#include "vision/preprocess.h"
+#include "vision/yolo_decoder.h"
+#include "vision/SceneChangeGate.h"
+#include "vision/FrameQualityGate.h"
+#include "vision/ObjectTracker.h"
+#include "vision/InferenceBackend.h"
+#include "vision/FrameSource.h"
+#include "vision/FrameRecorder.h"
+#include "vision/ResolutionController.h"
+#include "vision/ArtifactClassifier.h"
+#include "vision/InscriptionReader.h"
 #endif
 
+class EventBus;
+
+// 带跟踪ID的检测结果（trackId为-1表示该结果没有经过跟踪器）
+struct TrackedLabel {
+    int trackId;
+    std::string label;
+};
+
+// 碑文、书法作品上识别出的文字
+struct RecognizedInscription {
+    int trackId;
+    int labelId;        // 碑文或书法作品的标签ID
+    std::string text;
+    float confidence;   // 各字符概率的平均值
+
+    RecognizedInscription() : trackId(-1), labelId(-1), confidence(0.0f) {}
+};
+
 class VisionProcessor {
 public:
     VisionProcessor();
@@ -32,32 +74,210 @@ public:
     // 停止视觉检测
     void stop();
     
-    // 获取检测到的对象列表
+    // 获取检测到的对象列表（兼容接口，每次调用都会复制标签；新代码请使用getDetections()）
     std::vector<std::string> getDetectedObjects();
     
+    // 获取指定摄像头最新的检测结果（0为主摄像头）：只读视图，不复制结果也不分配内存，
+    // 包含检测框、置信度、类别ID、标签ID、跟踪ID和帧时间戳
+    DetectionView getDetections(int cameraId = 0) const;
+    
+    // 标签ID对应的名称（未知ID返回空字符串），返回的引用一直有效
+    const std::string& getLabelName(int labelId) const;
+    
     // 检查摄像头是否可用
     bool isCameraAvailable();
     
     // 设置检测灵敏度
     void setSensitivity(float sensitivity);
     
-    // 保存当前图像
+    // 保存当前图像（x86平台在后台线程中JPEG编码和写盘，调用方不等待）
     bool saveCurrentFrame(const std::string& filename);
     
+    // 设置事件片段的长度：事件前保留preEventFrames帧，事件后录制postEventFrames帧，在下次启动检测时生效。
+    // 默认事件前0帧、事件后15帧：不设置事件前帧数也没有自动录制时采集线程不复制帧，
+    // 快照保存下一帧，片段从下一帧开始
+    void setEventRecording(int preEventFrames, int postEventFrames);
+    
+    // 把当前时刻前后的片段以JPEG序列保存到directory（后台写入）
+    bool saveEventClip(const std::string& directory);
+    
+    // 检测到triggerLabels中的对象时自动保存事件片段到recordings目录，两次之间至少间隔cooldownMs毫秒；
+    // triggerLabels为空时关闭自动录制
+    void setRecordingTrigger(const std::vector<std::string>& triggerLabels, int cooldownMs);
+    
     // 加载YOLO模型（新增方法）
     bool loadYOLOModel(const std::string& modelPath);
     
     // 重置视觉处理系统
     void reset();
     
+    // 设置摄像头采集帧率（异步流水线的采集节拍）
+    void setCameraFrameRate(float fps);
+    
+    // 摄像头采集帧率（fps）
+    float getCameraFrameRate() const;
+    
+    // 设置事件总线，每次发布检测结果时发布DetectionsUpdatedEvent（为空时不发布）；需要在start()之前设置
+    void setEventBus(EventBus* bus);
+    
+    // 获取流水线因背压丢弃的帧数
+    size_t getDroppedFrameCount() const;
+    
+    // 获取视觉缓冲区的累计分配次数（稳态下应保持不变）
+    size_t getBufferAllocationCount() const;
+    
+    // 设置批量推理：最多攒batchSize帧，或等待deadlineMs毫秒后执行一次前向推理
+    // batchSize为1时关闭批量模式
+    void setBatchInference(int batchSize, int deadlineMs);
+    
+    // 配置场景变化门控：画面基本不变时跳过推理，沿用上一次的检测结果
+    // diffThreshold为缩略图平均灰度差，histogramThreshold为直方图L1距离，
+    // maxStaleMs为最长复用时间
+    void setSceneChangeGate(bool enabled, float diffThreshold, float histogramThreshold, int maxStaleMs);
+    
+    // 获取因画面未变化而跳过推理的帧所占比例
+    float getInferenceSkipRatio() const;
+    
+    // 配置帧质量门控（默认关闭）：缩小后灰度图的拉普拉斯方差低于minSharpness（运动模糊）、
+    // 或平均亮度不在[minLuma, maxLuma]内（欠曝/过曝）的帧不做推理，沿用上一次的检测结果；
+    // 连续拒绝超过maxRejectMs时放行一帧，检测不会完全停下
+    void setQualityGate(bool enabled, float minSharpness, float minLuma, float maxLuma, int maxRejectMs);
+    
+    // 指定摄像头最近一帧的清晰度和平均亮度评分（用于调参），还没有评估过时返回false
+    bool getFrameQuality(int cameraId, float& sharpness, float& luma) const;
+    
+    // 因模糊或曝光不佳而拒绝推理的帧所占比例
+    float getQualityRejectRatio() const;
+    
+#ifndef ESP32
+    // 从其他摄像头提交一帧图像，与主摄像头的帧一起参与批量推理
+    bool submitFrame(const cv::Mat& frame, int cameraId);
+    
+    // 以FP32模型的检测结果为基准，在imageDir中的图像上评估当前模型（通常为量化模型）的
+    // 召回率、精确率、IoU、置信度差和推理耗时；需要在停止检测时调用
+    bool reportQuantizationAccuracy(const std::string& referenceModelPath, const std::string& imageDir);
+#endif
+    
+    // 获取指定摄像头最新的检测结果（0为主摄像头）
+    std::vector<std::string> getDetectedObjects(int cameraId);
+    
+    // 设置高分辨率分块推理：长边超过模型输入1.5倍的帧切成相互重叠的切片分别推理，
+    // 结果跨切片合并；roiOnly为true时只在整图粗检测发现目标的区域内切片
+    void setTiledInference(bool enabled, bool roiOnly, float overlap);
+    
+    // 获取指定摄像头最新的带跟踪ID的检测结果，同一目标在画面中期间ID保持不变
+    std::vector<TrackedLabel> getTrackedObjects(int cameraId = 0);
+    
+    // 设置检测间隔：每interval帧运行一次检测器，中间帧由跟踪器推进检测框；
+    // 有轨迹丢失时立即重新检测。interval为1时每帧都检测
+    void setDetectionInterval(int interval);
+    
+    // 指定推理后端（"opencv-cpu"、"opencv-fp16"、"onnxruntime"、"tflite"或"auto"），
+    // 在下一次加载模型时生效；未指定时读取环境变量AICOMPANION_INFERENCE_BACKEND，
+    // 仍未指定则在加载时测速选择最快的后端
+    void setInferenceBackend(const std::string& name);
+    
+    // 获取当前使用的推理后端名称（未加载模型时为空）
+    std::string getInferenceBackendName() const;
+    
+    // 使用INT8量化模型（models/yolov5s-int8.onnx，或同名的.tflite），在下一次加载模型时生效；
+    // 也可以设置环境变量AICOMPANION_MODEL_PRECISION=int8
+    void setQuantizedModel(bool enabled);
+    
+    // 设置加载模型后的预热推理次数（默认2次），让延迟初始化和内存分配发生在首次检测之前
+    void setWarmupRuns(int runs);
+    
+    // 设置网络缓存目录（默认models/cache），后端选择和优化后的网络按模型哈希缓存在其中；
+    // 为空时不缓存。需要在initialize()之前调用
+    void setModelCacheDirectory(const std::string& dir);
+    
+    // 模型是否已加载完成（后台加载中，或未找到模型而使用模拟模式时返回false）
+    bool isModelReady() const;
+    
+    // 模型是否还在后台加载
+    bool isModelLoading() const;
+    
+    // 级联检测：每个待检测帧先由筛选模型（小模型、较小输入，例如320像素的yolov5n）推理，
+    // 只有发现文化相关类别、置信度模棱两可或到了定期刷新时才运行完整模型。
+    // 筛选模型需要与完整模型使用相同的类别，在下一次加载模型时生效；
+    // 也可以设置环境变量AICOMPANION_CASCADE_MODEL为筛选模型路径
+    void setCascadeDetection(bool enabled, const std::string& screeningModelPath, int inputSize, int refreshFrames);
+    
+    // 设置筛选模型发现后需要完整模型确认的类别（默认为能对应到文化文物的常见物体）
+    void setCascadeRelevantClasses(const std::vector<std::string>& classes);
+    
+    // 级联模式下运行完整模型的帧所占比例
+    float getCascadeEscalationRatio() const;
+    
+    // 第二阶段文物分类：从每个检测框裁剪区域，一帧的所有裁剪拼成一个批次一次推理，分类结果作为文物追加到
+    // 检测结果中；只由跟踪器推进的帧沿用各跟踪目标最近一次的分类结果。labelsPath为每行一个文物名称的文件，
+    // inputSize为分类模型的输入尺寸。在下一次加载模型时生效，也可以设置环境变量AICOMPANION_ARTIFACT_MODEL
+    // （类别文件默认为models/artifacts.names）；没有分类模型时按常见物体到文物的映射识别
+    void setArtifactClassifier(const std::string& modelPath, const std::string& labelsPath, int inputSize);
+    
+    // 碑文、书法作品的文字识别：只对这两类目标的检测框找出文字行，一帧的所有文字行一次批量推理，
+    // 在单独的工作线程中进行；结果按跟踪ID缓存，同一块碑在画面中期间不重复识别。
+    // dictPath为识别模型的字典（每行一个字符，默认为models/ocr_keys.txt），模型输入为
+    // inputHeight×inputWidth。在下一次加载模型时生效，也可以设置环境变量AICOMPANION_OCR_MODEL
+    void setInscriptionReader(const std::string& modelPath, const std::string& dictPath,
+                              int inputHeight, int inputWidth);
+    
+    // 指定摄像头画面中已识别出文字的碑文、书法作品（每个跟踪目标一项），可以作为文化讲解的检索关键词；
+    // 结果写入inscriptions，其中的字符串容量在调用之间复用
+    void getRecognizedInscriptions(std::vector<RecognizedInscription>& inscriptions, int cameraId = 0) const;
+    
+    // 自适应输入分辨率：按每帧推理延迟预算（毫秒）和整机CPU占用在几档输入尺寸（例如320、416、640，
+    // 须为32的倍数）之间切换，带滞回避免来回切换。加载模型时逐档试推理，只使用模型实际支持的尺寸
+    // （按动态形状导出的模型不需要重新加载，固定尺寸的模型只保留640）。
+    // 启用和尺寸列表在下一次加载模型时生效，预算立即生效；关闭时立即恢复640
+    void setAdaptiveResolution(bool enabled, float budgetMs, const std::vector<int>& sizes);
+    
+    // 当前的模型输入尺寸
+    int getModelInputSize() const;
+    
+    // 自适应分辨率的累计切换次数
+    size_t getResolutionSwitchCount() const;
+    
+    // 指定帧来源（格式见createFrameSource()：视频文件、图像目录、"路径.yuv:宽x高[:格式]"、
+    // "camera:N"或"synthetic"），需要在initialize()之前调用；未指定时读取环境变量
+    // AICOMPANION_FRAME_SOURCE，仍未指定则使用模拟摄像头。
+    // realTime为true时按来源帧率回放（未知时按采集帧率），帧处理不过来时丢弃最旧的帧；
+    // 为false时尽快回放，各阶段等待下游而不丢帧，用于测量吞吐
+    void setFrameSource(const std::string& spec, bool realTime);
+    
+    // 文件类来源是否已经读完（读完后采集线程退出，已采集的帧继续处理）
+    bool isFrameSourceFinished() const;
+    
+    // 流水线中是否没有正在处理的帧
+    bool isPipelineIdle() const;
+    
+    // 已采集的帧数
+    size_t getCapturedFrameCount() const;
+    
+    // 记录流水线各阶段的耗时（默认关闭），启用时清空之前的记录
+    void setLatencyRecording(bool enabled);
+    
+    // 一个阶段的耗时统计
+    StageLatency getStageLatency(PipelineStage stage) const;
+    
 private:
     // 系统状态
-    bool isRunning;
+    std::atomic<bool> isRunning;
     bool cameraAvailable;
-    float detectionSensitivity;
+    std::atomic<float> detectionSensitivity;
+    std::atomic<bool> modelReady;
+    
+    // 各摄像头最新一次完成的检测结果（在x86平台上由后处理线程发布）
+    LabelTable labels;
+    mutable std::mutex resultMutex;
+    std::map<int, DetectionResultSlot> resultSlots;
+    EventBus* eventBus;
     
-    // 检测到的对象列表
-    std::vector<std::string> detectedObjects;
+    // 模拟模式和文物识别使用的标签ID（构造时驻留）
+    std::vector<int> simulatedLabelIds;
+    std::vector<int> importantArtifactLabelIds;   // 与simulatedLabelIds一一对应的“重要”文物
+    std::map<int, int> artifactLabelIds;          // 常见物体 → 文化文物
+    std::vector<int> inscriptionLabelIds;         // 需要识别文字的类别（碑文、书法作品）
     
     // YOLO模型相关变量（ESP32平台）
 #ifdef ESP32
@@ -73,8 +293,294 @@ private:
     }  // namespace
 #else
     // YOLO模型相关变量（x86平台）
-    cv::dnn::Net yoloNet;
+    std::unique_ptr<InferenceBackend> inferenceBackend;
+    std::string preferredBackend;
+    bool useQuantizedModel;
     std::vector<std::string> classNames;
+    std::vector<int> classLabelIds;  // 各模型类别驻留后的标签ID
+    YOLOOutputLayout outputLayout;  // 加载模型时根据输出形状确定
+    std::vector<QuantizationParams> outputQuantization;  // 各输出的量化参数（量化模型）
+    bool normalizedBoxes;           // 模型输出坐标是否归一化到[0,1]
+    
+    // 级联检测的筛选模型（由后台加载线程创建，之后只由预处理和推理线程使用）
+    struct ScreeningModel {
+        std::unique_ptr<InferenceBackend> backend;
+        int inputSize;
+        YOLOOutputLayout outputLayout;
+        std::vector<QuantizationParams> outputQuantization;
+        bool normalizedBoxes;
+        bool sharesInput;               // 输入类型与完整模型相同，尺寸也相同时直接使用同一个输入张量
+        
+        // 推理线程复用的输出和解码缓冲区
+        std::vector<cv::Mat> outputs;
+        YOLODecodeWorkspace decode;
+        std::vector<cv::Rect> candidateBoxes;
+        std::vector<float> candidateConfidences;
+        std::vector<int> candidateClassIds;
+        NMSWorkspace nms;
+        std::vector<int> nmsIndices;
+        std::vector<cv::Rect> boxes;
+        std::vector<float> confidences;
+        std::vector<int> classIds;
+        
+        ScreeningModel() : inputSize(320), outputLayout(YOLOOutputLayout::RowsWithObjectness),
+                           normalizedBoxes(false), sharesInput(false) {}
+    };
+    ScreeningModel screening;
+    std::atomic<bool> cascadeEnabled;
+    std::string cascadeModelPath;
+    int cascadeInputSize;
+    std::atomic<int> cascadeRefreshFrames;
+    std::mutex cascadeMutex;
+    std::vector<int> cascadeRelevantLabelIds;   // 空表示使用文物映射中的常见物体
+    std::map<int, int> framesSinceFullModel;    // 推理线程使用
+    PreprocessWorkspace cascadePreprocess;      // 推理线程为完整模型补做预处理时使用
+    std::atomic<size_t> cascadeScreenedCount;
+    std::atomic<size_t> cascadeEscalatedCount;
+    
+    // 第二阶段文物分类（由后台加载线程加载，之后只由后处理线程使用）
+    struct ClassifiedArtifact {
+        int labelId;
+        float score;
+    };
+    ArtifactClassifier artifactClassifier;
+    std::string artifactModelPath;
+    std::string artifactLabelsPath;
+    int artifactInputSize;
+    std::vector<int> artifactClassLabelIds;     // 分类器类别驻留后的标签ID
+    std::map<std::pair<int, int>, ClassifiedArtifact> classifiedTracks;   // (摄像头, 跟踪ID) → 最近的分类结果
+    std::vector<size_t> artifactSources;        // 参与分类的检测结果下标
+    std::vector<cv::Rect> artifactBoxes;
+    std::vector<ArtifactPrediction> artifactPredictions;
+    
+    // 碑文、书法作品的文字识别（由后台加载线程加载，识别在其工作线程中进行）
+    InscriptionReader inscriptionReader;
+    std::string inscriptionModelPath;
+    std::string inscriptionDictPath;
+    int inscriptionInputHeight;
+    int inscriptionInputWidth;
+    std::vector<InscriptionRegion> inscriptionRegions;   // 后处理线程使用
+    std::vector<int> activeTrackIds;
+    
+    // 自适应输入分辨率：控制器只由推理线程使用，配置在resolutionMutex保护下修改；
+    // 预处理线程按modelInputSize准备下一帧的输入，解码时按各帧信箱参数中的尺寸换算
+    std::atomic<bool> adaptiveResolution;
+    std::atomic<int> modelInputSize;
+    std::vector<int> requestedInputSizes;
+    mutable std::mutex resolutionMutex;
+    ResolutionController resolutionController;
+    CpuLoadMonitor cpuLoadMonitor;
+    
+    // 后台加载模型：initialize()不等待加载完成，加载期间流水线不使用模型、不发布结果
+    std::thread modelLoader;
+    std::atomic<bool> modelLoading;
+    std::atomic<int> warmupRuns;
+    std::string modelCacheDir;
+    std::chrono::steady_clock::time_point initializeTime;
+    bool firstDetectionReported;    // 后处理线程使用
+    
+    // 异步流水线：采集 → 预处理 → 推理 → 解码/NMS，各阶段之间通过有界队列连接
+    // 队列中传递的是帧缓冲池中的槽位，被丢弃的槽位归还给缓冲池
+    FrameBufferPool framePool;
+    BoundedQueue<FrameSlot*> captureQueue;
+    BoundedQueue<FrameSlot*> preprocessQueue;
+    BoundedQueue<FrameSlot*> inferenceQueue;
+    std::vector<std::thread> pipelineThreads;
+    std::atomic<bool> pipelineRunning;
+    std::atomic<int> captureIntervalMs;
+    
+    // 帧来源（initializeCamera()中创建，只由采集线程读取）
+    std::unique_ptr<FrameSource> frameSource;
+    std::string frameSourceSpec;
+    bool realTimeReplay;
+    std::atomic<bool> losslessReplay;   // 尽快回放的离线来源：队列满时等待，不丢帧
+    std::atomic<bool> sourceFinished;
+    std::atomic<size_t> capturedFrameCount;
+    
+    // 各阶段耗时统计
+    std::atomic<bool> latencyRecording;
+    PipelineStats pipelineStats;
+    
+    // 最近帧的环形缓冲区和后台编码线程：快照、事件片段和调试图像都不在流水线线程中写盘
+    FrameRecorder frameRecorder;
+    std::atomic<int> recordPreEventFrames;
+    std::atomic<int> recordPostEventFrames;
+    std::mutex recordingMutex;
+    std::vector<int> recordingTriggerLabelIds;
+    int recordingCooldownMs;
+    bool eventClipRecorded;
+    std::chrono::steady_clock::time_point lastEventClip;
+    
+    // 批量推理配置
+    std::atomic<int> batchSize;
+    std::atomic<int> batchDeadlineMs;
+    cv::Mat batchBlob;
+    
+    // 预处理内核的复用工作区（仅预处理线程使用）
+    PreprocessWorkspace preprocessWorkspace;
+    
+    // 场景变化门控和帧质量门控（每个摄像头一个实例，由预处理线程使用）
+    mutable std::mutex gateMutex;
+    SceneChangeGateConfig gateConfig;
+    std::map<int, SceneChangeGate> sceneGates;
+    std::atomic<bool> sceneGateEnabled;
+    std::atomic<size_t> gatedFrameCount;
+    std::atomic<size_t> skippedFrameCount;
+    FrameQualityGateConfig qualityConfig;
+    std::map<int, FrameQualityGate> qualityGates;
+    std::atomic<bool> qualityGateEnabled;
+    std::atomic<size_t> qualityCheckedCount;
+    std::atomic<size_t> qualityRejectedCount;
+    
+    // 检测+跟踪：每个摄像头一个跟踪器
+    struct CameraTracking {
+        ObjectTracker tracker;
+        int framesSinceDetection;
+        bool needsDetection;
+        
+        CameraTracking() : framesSinceDetection(0), needsDetection(true) {}
+    };
+    std::mutex trackingMutex;
+    std::map<int, CameraTracking> tracking;
+    std::atomic<int> detectionInterval;
+    std::vector<TrackedObject> activeTracks;  // 后处理线程复用
+    
+    // 高分辨率分块推理（推理线程使用）
+    struct TileContext {
+        cv::Rect rect;
+        LetterboxInfo letterbox;
+        PreprocessWorkspace preprocess;
+        YOLODecodeWorkspace decode;
+        std::vector<cv::Mat> outputs;   // 不支持批量推理时逐片推理的输出
+        std::vector<cv::Rect> boxes;
+        std::vector<float> confidences;
+        std::vector<int> classIds;
+    };
+    std::atomic<bool> tilingEnabled;
+    std::atomic<bool> tilingRoiOnly;
+    std::atomic<float> tileOverlap;
+    bool tileBatchSupported;
+    std::unique_ptr<ThreadPool> tilePool;
+    std::vector<TileContext> tileContexts;
+    std::vector<cv::Rect> tileRects;
+    cv::Mat tileBlob;
+    std::vector<cv::Mat> tileOutputs;
+    YOLODecodeWorkspace tileDecodeWorkspace;
+    std::vector<cv::Rect> tileCandidateBoxes;
+    std::vector<float> tileCandidateConfidences;
+    std::vector<int> tileCandidateClassIds;
+    NMSWorkspace tileNmsWorkspace;
+    std::vector<int> tileNmsIndices;
+    
+    // 解码阶段复用的候选框和结果缓冲区
+    std::vector<cv::Rect> candidateBoxes;
+    std::vector<float> candidateConfidences;
+    std::vector<int> candidateClassIds;
+    YOLODecodeWorkspace decodeWorkspace;
+    std::vector<cv::Rect> keptBoxes;
+    std::vector<float> keptConfidences;
+    std::vector<int> keptClassIds;
+    NMSWorkspace nmsWorkspace;
+    std::vector<int> nmsIndices;
+    
+    // 加载级联检测的筛选模型（使用与完整模型相同的推理后端）
+    bool loadScreeningModel(const std::string& modelPath, const std::string& cacheDir);
+    
+    // 级联模式下预处理线程为筛选模型准备输入
+    void preprocessForScreening(FrameSlot& slot);
+    
+    // 用筛选模型推理一帧：返回true表示还需要完整模型（输入张量已准备好）；
+    // 返回false时筛选模型的检测结果已写入slot
+    bool screenFrame(FrameSlot& slot);
+    
+    // 筛选模型的检测类别是否需要完整模型确认（调用时已持有cascadeMutex）
+    bool isCascadeRelevant(int classId);
+    
+    // 逐档试推理，返回模型支持的输入尺寸（按固定尺寸导出的模型只返回原尺寸）
+    std::vector<int> probeInputSizes(const std::vector<cv::Mat>& nativeOutputs);
+    
+    // 推理线程报告一帧整图推理的耗时，由控制器决定之后的输入尺寸
+    void noteInferenceLatency(int inputSize, double forwardMs);
+    
+    // 后台线程：加载模型、预热，量化模型还会与参考模型对比精度
+    void loadModelInBackground(const std::string& modelPath, const std::string& referenceModelPath);
+    
+    // 等待上一次的后台加载结束
+    void joinModelLoader();
+    
+    // 启动/停止流水线线程
+    void startPipeline();
+    void stopPipeline();
+    
+    // 入队，队列满时把被丢弃的槽位归还给缓冲池（尽快回放时等待下游）
+    void pushSlot(BoundedQueue<FrameSlot*>& queue, FrameSlot* slot);
+    
+    // 流水线各阶段的线程函数
+    void captureLoop();
+    void preprocessLoop();
+    void inferenceLoop();
+    void postprocessLoop();
+    
+    // 从帧来源读取一帧图像到复用的缓冲区
+    bool captureFrame(cv::Mat& frame);
+    
+    // 场景变化门控：返回false时这一帧不需要推理
+    bool passSceneGate(const FrameSlot& slot);
+    
+    // 帧质量门控：返回false时这一帧太模糊或曝光不佳，不需要推理
+    bool passQualityGate(const FrameSlot& slot);
+    
+    // 决定这一帧是运行检测器还是只由跟踪器推进
+    bool scheduleDetection(int cameraId);
+    
+    // 将图像转换为模型输入（blob为复用的输入张量），返回信箱缩放参数
+    LetterboxInfo preprocessFrame(const cv::Mat& frame, cv::Mat& blob);
+    
+    // 模型输入张量的元素类型（float，或全整型量化模型的uint8/int8）
+    int inputDepth() const;
+    
+    // 按模型输入类型把图像写入一个 3×inputSize×inputSize 的输入张量
+    LetterboxInfo letterboxInto(const cv::Mat& image, int inputSize, uchar* dst,
+                                PreprocessWorkspace& workspace) const;
+    
+    // 执行一次前向推理
+    bool runInference(const cv::Mat& blob, std::vector<cv::Mat>& outputs);
+    
+    // 用槽位自己的输入和输出张量单独推理一帧
+    bool runSlotInference(FrameSlot& slot);
+    
+    // 将多帧拼成一个N批次输入执行一次前向推理
+    bool runBatchInference(std::vector<FrameSlot*>& batch);
+    
+    // 高分辨率帧的分块推理：整图推理 + 切片批量推理 + 跨切片合并，结果写入slot
+    bool shouldTile(const FrameSlot& slot) const;
+    bool runTiledInference(FrameSlot& slot);
+    
+    // 解码模型输出，把通过阈值的候选框追加到输出列表（inputSize为这次推理的输入尺寸）
+    void decodeCandidates(const std::vector<cv::Mat>& outputs, int batchIndex, int inputSize,
+                          const YOLOBoxMapping& mapping, const cv::Size& frameSize,
+                          float confThreshold, YOLODecodeWorkspace& workspace,
+                          std::vector<cv::Rect>& boxes, std::vector<float>& confidences,
+                          std::vector<int>& classIds) const;
+    
+    // 解码模型输出并生成对象列表
+    void decodeOutputs(const std::vector<cv::Mat>& outputs, int batchIndex,
+                       const LetterboxInfo& letterbox, const cv::Size& frameSize,
+                       std::vector<cv::Rect>& boxes, std::vector<float>& confidences,
+                       std::vector<int>& classIds);
+    
+    // 用本帧的检测结果（或运动模型）更新跟踪器，追加当前带跟踪ID的目标
+    void updateTracks(const FrameSlot& slot, std::vector<Detection>& detections);
+    
+    // 用文物分类模型识别本帧的文物，追加到检测结果之后（后处理线程调用）
+    void classifyArtifacts(const FrameSlot& slot, std::vector<Detection>& detections);
+    
+    // 把本帧的碑文、书法作品交给文字识别线程，并删除已结束跟踪的识别结果（后处理线程调用）
+    void readInscriptions(const FrameSlot& slot, const std::vector<Detection>& detections);
+    
+    // 检测结果中出现触发录制的对象时请求保存事件片段（后处理线程调用）
+    void checkRecordingTrigger(const DetectionFrame& frame);
+
 #endif
     
     // 初始化摄像头
@@ -86,11 +592,26 @@ private:
     // 处理图像
     void processImage(void* imageData);
     
-    // 执行目标检测
-    void detectObjects(void* imageData);
+#ifdef ESP32
+    // 执行目标检测，结果追加到detections（x86平台的检测在流水线线程中进行）
+    void detectObjects(void* imageData, std::vector<Detection>& detections);
     
     // 识别文化文物
-    void recognizeCulturalArtifacts(void* imageData);
+    void recognizeCulturalArtifacts(void* imageData, std::vector<Detection>& detections);
+#endif
+    
+    // 模拟模式下随机生成检测结果
+    void simulateDetections(std::vector<Detection>& detections,
+                            std::chrono::steady_clock::time_point timestamp);
+    
+    // 根据检测对象追加识别出的文化文物
+    void appendCulturalArtifacts(std::vector<Detection>& detections);
+    
+    // 指定摄像头的结果槽位（不存在时创建）
+    DetectionResultSlot& resultSlot(int cameraId);
+    
+    // 发布一次检测结果后通知事件总线的订阅者
+    void publishDetectionsEvent(int cameraId, const DetectionFrame& frame);
 };
 
 #endif // VISION_PROCESSOR_H
\ No newline at end of file
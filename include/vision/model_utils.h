@@ -2,6 +2,8 @@
 #define MODEL_UTILS_H
 
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 #ifdef ESP32
 // ESP32环境不需要OpenCV
@@ -10,17 +12,88 @@
 #endif
 
 /**
- * @brief 非最大抑制算法，用于过滤重叠的检测框
+ * @brief 信箱缩放（letterbox）参数
+ *
+ * 图像按比例缩放后居中放入模型输入，四周用灰色填充。
+ * 原图坐标 = (模型输入坐标 - pad) / scale
+ */
+struct LetterboxInfo {
+    float scale;      // 缩放比例
+    int padX;         // 左侧填充像素数
+    int padY;         // 上方填充像素数
+    int inputWidth;   // 模型输入宽度
+    int inputHeight;  // 模型输入高度
+};
+
+/**
+ * @brief INT8量化张量的仿射参数
+ *
+ * 实数值 = (量化值 - zeroPoint) × scale。isSigned为true时张量元素为int8，否则为uint8。
+ */
+struct QuantizationParams {
+    float scale;
+    int zeroPoint;
+    bool isSigned;
+
+    QuantizationParams() : scale(1.0f), zeroPoint(0), isSigned(false) {}
+
+    float dequantize(int q) const { return (q - zeroPoint) * scale; }
+
+    // 四舍五入并饱和到元素类型的取值范围
+    int quantize(float value) const {
+        float q = value / scale + zeroPoint;
+        int rounded = static_cast<int>(q < 0.0f ? q - 0.5f : q + 0.5f);
+        const int lo = isSigned ? -128 : 0;
+        const int hi = isSigned ? 127 : 255;
+        return rounded < lo ? lo : (rounded > hi ? hi : rounded);
+    }
+};
+
+/**
+ * @brief NMS的类别处理方式
+ */
+enum class NMSMode {
+    ClassAgnostic,  // 不区分类别，重叠的框之间互相抑制
+    PerClass,       // 只在同一类别的框之间抑制
+    ClassOffset     // 按类别平移坐标后统一抑制（与批量NMS的常见写法一致，结果与PerClass相同）
+};
+
+/**
+ * @brief NMS的复用工作区
+ *
+ * 候选框按分数排序后以SoA（结构数组）形式存放坐标，便于向量化计算IoU；
+ * 被抑制的框记录在位图中。缓冲区在调用之间复用，稳态下不产生堆分配。
+ */
+struct NMSWorkspace {
+    std::vector<int> order;            // 按分数降序排列的候选索引
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> x2;
+    std::vector<float> y2;
+    std::vector<float> area;
+    std::vector<int> classIds;
+    std::vector<uint64_t> suppressed;  // 被抑制标记位图
+};
+
+/**
+ * @brief 排序 + 位图的O(n log n)非最大抑制，支持按类别抑制
  * @param boxes 检测框列表
  * @param scores 检测框的置信度分数
+ * @param classIds 检测框的类别ID（ClassAgnostic模式下可为空）
  * @param scoreThreshold 分数阈值
  * @param nmsThreshold NMS阈值
- * @return 过滤后的检测框索引
+ * @param mode 类别处理方式
+ * @param workspace 复用的工作区
+ * @param indices 输出的保留框索引（按分数降序；PerClass模式下按类别分组，组内按分数降序）
  */
-std::vector<int> applyNMS(const std::vector<cv::Rect>& boxes, 
-                         const std::vector<float>& scores, 
-                         float scoreThreshold, 
-                         float nmsThreshold);
+void applyNMS(const std::vector<cv::Rect>& boxes, 
+              const std::vector<float>& scores, 
+              const std::vector<int>& classIds, 
+              float scoreThreshold, 
+              float nmsThreshold, 
+              NMSMode mode, 
+              NMSWorkspace& workspace, 
+              std::vector<int>& indices);
 
 /**
  * @brief 计算两个矩形框的交并比(IoU)
@@ -30,6 +103,30 @@ std::vector<int> applyNMS(const std::vector<cv::Rect>& boxes,
  */
 float calculateIoU(const cv::Rect& box1, const cv::Rect& box2);
 
+/**
+ * @brief 判断分类输出是否已经是概率分布（每项在[0,1]内且和为1）
+ * @param values 分类输出
+ * @param count 类别数
+ * @return 已经是概率分布时返回true
+ */
+bool isProbabilityDistribution(const float* values, size_t count);
+
+/**
+ * @brief 把分类输出原地转换为概率：已经是概率分布时保持不变，否则（logits或log-softmax）做softmax
+ * @param values 分类输出，转换结果写回原处
+ * @param count 类别数
+ */
+void toProbabilities(float* values, size_t count);
+
+/**
+ * @brief 检测框每边向外扩展margin倍的宽高，给第二阶段模型留一圈上下文
+ * @param box 检测框（原图坐标）
+ * @param margin 每边扩展的比例
+ * @param imageSize 原图尺寸，结果裁剪到图像范围内
+ * @return 扩展后的区域
+ */
+cv::Rect2f expandBox(const cv::Rect& box, float margin, const cv::Size& imageSize);
+
 /**
  * @brief 对YOLO模型的输出进行后处理，获取检测框和类别
  * @param outputs 模型输出
@@ -50,6 +147,153 @@ void processYOLOOutput(const cv::Mat& outputs,
                       std::vector<float>& confidences, 
                       std::vector<int>& classIds);
 
+/**
+ * @brief 对INT8量化模型的YOLO输出（CV_8U/CV_8S）进行后处理
+ *
+ * 阈值比较在查表反量化后进行，只有通过目标置信度筛选的行才完整反量化；
+ * 输出为float张量时与上一个重载相同。
+ * @param quantization 输出张量的量化参数
+ * 其余参数同上
+ */
+void processYOLOOutput(const cv::Mat& outputs, 
+                      const QuantizationParams& quantization,
+                      float confidenceThreshold, 
+                      float nmsThreshold, 
+                      int imageWidth, 
+                      int imageHeight, 
+                      std::vector<cv::Rect>& boxes, 
+                      std::vector<float>& confidences, 
+                      std::vector<int>& classIds);
+
+/**
+ * @brief 解码一个 N×D 的YOLO输出，将通过阈值的候选框追加到输出列表
+ *        （不清空输出列表、不做NMS，便于多个输出层复用同一组缓冲区）
+ * @param outputs 模型输出
+ * @param confidenceThreshold 置信度阈值
+ * @param imageWidth 图像宽度
+ * @param imageHeight 图像高度
+ * @param boxes 追加的检测框
+ * @param confidences 追加的置信度
+ * @param classIds 追加的类别ID
+ */
+void decodeYOLOCandidates(const cv::Mat& outputs, 
+                          float confidenceThreshold, 
+                          int imageWidth, 
+                          int imageHeight, 
+                          std::vector<cv::Rect>& boxes, 
+                          std::vector<float>& confidences, 
+                          std::vector<int>& classIds);
+
+/**
+ * @brief 解码经过信箱缩放预处理的YOLO输出（坐标为模型输入像素坐标），
+ *        并映射回原图坐标后追加到输出列表
+ * @param outputs 模型输出
+ * @param confidenceThreshold 置信度阈值
+ * @param letterbox 预处理时使用的信箱缩放参数
+ * @param imageWidth 原图宽度
+ * @param imageHeight 原图高度
+ * @param boxes 追加的检测框
+ * @param confidences 追加的置信度
+ * @param classIds 追加的类别ID
+ */
+void decodeYOLOCandidates(const cv::Mat& outputs, 
+                          float confidenceThreshold, 
+                          const LetterboxInfo& letterbox, 
+                          int imageWidth, 
+                          int imageHeight, 
+                          std::vector<cv::Rect>& boxes, 
+                          std::vector<float>& confidences, 
+                          std::vector<int>& classIds);
+
+/**
+ * @brief 对候选框执行NMS，并把保留下来的结果写入输出列表（输出列表会先被清空）
+ * @param boxes 候选检测框
+ * @param confidences 候选置信度
+ * @param classIds 候选类别ID
+ * @param scoreThreshold 分数阈值
+ * @param nmsThreshold NMS阈值
+ * @param keptBoxes 保留的检测框
+ * @param keptConfidences 保留的置信度
+ * @param keptClassIds 保留的类别ID
+ */
+void selectNMSResults(const std::vector<cv::Rect>& boxes, 
+                      const std::vector<float>& confidences, 
+                      const std::vector<int>& classIds, 
+                      float scoreThreshold, 
+                      float nmsThreshold, 
+                      std::vector<cv::Rect>& keptBoxes, 
+                      std::vector<float>& keptConfidences, 
+                      std::vector<int>& keptClassIds);
+
+/**
+ * @brief 使用复用工作区对候选框执行按类别的NMS，并把保留下来的结果写入输出列表
+ * @param boxes 候选检测框
+ * @param confidences 候选置信度
+ * @param classIds 候选类别ID
+ * @param scoreThreshold 分数阈值
+ * @param nmsThreshold NMS阈值
+ * @param workspace 复用的NMS工作区
+ * @param indices 复用的索引缓冲区
+ * @param keptBoxes 保留的检测框
+ * @param keptConfidences 保留的置信度
+ * @param keptClassIds 保留的类别ID
+ */
+void selectNMSResults(const std::vector<cv::Rect>& boxes, 
+                      const std::vector<float>& confidences, 
+                      const std::vector<int>& classIds, 
+                      float scoreThreshold, 
+                      float nmsThreshold, 
+                      NMSWorkspace& workspace, 
+                      std::vector<int>& indices, 
+                      std::vector<cv::Rect>& keptBoxes, 
+                      std::vector<float>& keptConfidences, 
+                      std::vector<int>& keptClassIds);
+
+/**
+ * @brief 把区域划分为相互重叠的正方形切片，用于高分辨率图像的分块推理
+ * @param region 需要覆盖的区域（通常为整幅图像，或粗检测得到的感兴趣区域）
+ * @param imageSize 图像尺寸，切片不会超出图像范围
+ * @param tileSize 切片边长（等于模型输入尺寸时切片无需缩放）
+ * @param overlap 相邻切片的重叠比例（0-0.5）
+ * @param tiles 追加的切片矩形
+ */
+void computeTiles(const cv::Rect& region,
+                  const cv::Size& imageSize,
+                  int tileSize,
+                  float overlap,
+                  std::vector<cv::Rect>& tiles);
+
+/**
+ * @brief 合并来自多个切片（以及整图推理）的检测结果
+ *
+ * 先按类别执行NMS去掉重叠切片中的重复检测；再处理被切片边界截断的目标：
+ * 同类别的两个框中，若较小的框大部分落在较大的框内（交集/较小框面积超过阈值），
+ * 去掉分数较低的那个。
+ *
+ * @param boxes 所有切片的检测框（已映射到原图坐标）
+ * @param confidences 置信度
+ * @param classIds 类别ID
+ * @param scoreThreshold 分数阈值
+ * @param nmsThreshold NMS阈值
+ * @param containmentThreshold 截断框的包含比例阈值
+ * @param workspace 复用的NMS工作区
+ * @param indices 复用的索引缓冲区
+ * @param keptBoxes 保留的检测框
+ * @param keptConfidences 保留的置信度
+ * @param keptClassIds 保留的类别ID
+ */
+void mergeTiledDetections(const std::vector<cv::Rect>& boxes,
+                          const std::vector<float>& confidences,
+                          const std::vector<int>& classIds,
+                          float scoreThreshold,
+                          float nmsThreshold,
+                          float containmentThreshold,
+                          NMSWorkspace& workspace,
+                          std::vector<int>& indices,
+                          std::vector<cv::Rect>& keptBoxes,
+                          std::vector<float>& keptConfidences,
+                          std::vector<int>& keptClassIds);
+
 /**
  * @brief 在图像上绘制检测结果
  * @param image 输入图像
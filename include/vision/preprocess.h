@@ -0,0 +1,68 @@
+#ifndef PREPROCESS_H
+#define PREPROCESS_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "vision/model_utils.h"
+
+/**
+ * @brief 预处理内核的复用工作区
+ *
+ * 保存水平插值查找表和行缓冲区，尺寸不变时在帧之间复用，不产生堆分配。
+ */
+struct PreprocessWorkspace {
+    std::vector<int> xOffset0;     // 左侧采样点在行缓冲区中的偏移（像素×3）
+    std::vector<int> xOffset1;     // 右侧采样点在行缓冲区中的偏移（像素×3）
+    std::vector<float> xWeight;    // 右侧采样点的权重
+    std::vector<float> rowBuffer;  // 垂直插值后的一行（BGR交错，已归一化）
+    std::vector<float> planeRows;  // 量化输出：水平插值后的R、G、B三行
+    int cachedSrcWidth;
+    int cachedDstWidth;
+
+    PreprocessWorkspace() : cachedSrcWidth(0), cachedDstWidth(0) {}
+};
+
+/**
+ * @brief 融合的YOLO预处理内核
+ *
+ * 一次遍历完成：信箱缩放（双线性插值，保持宽高比，灰色填充）、BGR→RGB、
+ * 归一化到[0,1]，并直接以平面CHW格式写入模型输入张量。
+ * 垂直插值与归一化使用AVX2/SSE2向量化，水平插值在AVX2下使用gather，
+ * 不支持的平台使用标量实现。
+ *
+ * @param bgr 输入图像（8位三通道BGR）
+ * @param dst 输出张量数据（3×dstHeight×dstWidth 的float）
+ * @param dstWidth 模型输入宽度
+ * @param dstHeight 模型输入高度
+ * @param workspace 复用的工作区
+ * @return 信箱缩放参数，用于把检测框映射回原图
+ */
+LetterboxInfo letterboxToTensor(const cv::Mat& bgr,
+                                float* dst,
+                                int dstWidth,
+                                int dstHeight,
+                                PreprocessWorkspace& workspace);
+
+/**
+ * @brief 全整型量化模型的预处理内核
+ *
+ * 与letterboxToTensor相同的缩放和通道处理，但不输出float：每行插值结果
+ * 直接按输入张量的量化参数量化为uint8/int8写入CHW张量。对于常见的
+ * scale=1/255、zeroPoint=0的uint8输入，写入的就是插值后的原始像素值。
+ *
+ * @param bgr 输入图像（8位三通道BGR）
+ * @param dst 输出张量数据（3×dstHeight×dstWidth 的uint8或int8）
+ * @param dstWidth 模型输入宽度
+ * @param dstHeight 模型输入高度
+ * @param quantization 输入张量的量化参数
+ * @param workspace 复用的工作区
+ * @return 信箱缩放参数
+ */
+LetterboxInfo letterboxToTensorQuantized(const cv::Mat& bgr,
+                                         uint8_t* dst,
+                                         int dstWidth,
+                                         int dstHeight,
+                                         const QuantizationParams& quantization,
+                                         PreprocessWorkspace& workspace);
+
+#endif // PREPROCESS_H
@@ -0,0 +1,188 @@
+#ifndef YOLO_DECODER_H
+#define YOLO_DECODER_H
+
+#include <vector>
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include "vision/model_utils.h"
+
+/**
+ * @brief 模型输出坐标到原图坐标的线性映射
+ *
+ * 原图坐标 = 模型输出坐标 × scale + offset
+ */
+struct YOLOBoxMapping {
+    float scaleX;
+    float scaleY;
+    float offsetX;
+    float offsetY;
+
+    // 坐标为模型输入像素，需要去掉信箱填充再缩放回原图
+    static YOLOBoxMapping fromLetterbox(const LetterboxInfo& letterbox) {
+        const float invScale = letterbox.scale > 0.0f ? 1.0f / letterbox.scale : 1.0f;
+        YOLOBoxMapping mapping;
+        mapping.scaleX = invScale;
+        mapping.scaleY = invScale;
+        mapping.offsetX = -letterbox.padX * invScale;
+        mapping.offsetY = -letterbox.padY * invScale;
+        return mapping;
+    }
+
+    // 坐标已归一化到[0,1]，直接乘以原图尺寸
+    static YOLOBoxMapping normalized(int imageWidth, int imageHeight) {
+        YOLOBoxMapping mapping;
+        mapping.scaleX = static_cast<float>(imageWidth);
+        mapping.scaleY = static_cast<float>(imageHeight);
+        mapping.offsetX = 0.0f;
+        mapping.offsetY = 0.0f;
+        return mapping;
+    }
+};
+
+/**
+ * @brief YOLO输出张量的布局
+ */
+enum class YOLOOutputLayout {
+    RowsWithObjectness,  // YOLOv5：N×(5+C)，每行 [cx, cy, w, h, obj, cls...]
+    ChannelsFirst        // YOLOv8/v11：(4+C)×N，每个通道连续存放所有候选框，无目标置信度
+};
+
+/**
+ * @brief 根据模型输出形状判断布局
+ *
+ * 去掉前导的批次维度后按二维 A×B 判断：A < B 为通道优先（如 84×8400），
+ * 否则为逐行格式（如 25200×85）。
+ *
+ * @param shape 模型输出形状（如 {1, 84, 8400}）
+ * @return 输出布局
+ */
+YOLOOutputLayout detectYOLOLayout(const std::vector<int>& shape);
+
+/**
+ * @brief YOLO解码器的复用工作区
+ */
+struct YOLODecodeWorkspace {
+    std::vector<int> survivors;     // 通过置信度筛选的候选框序号
+    std::vector<float> bestScores;  // 通道优先布局：每个候选框的最高类别得分
+    std::vector<int> bestClasses;   // 通道优先布局：最高得分对应的类别
+    std::vector<float> dequantized; // 量化输出：反量化后的一行或一个通道
+    std::vector<float> lookup;      // 量化输出：256项反量化查找表（按字节位模式索引）
+    QuantizationParams lookupParams;
+};
+
+/**
+ * @brief 向量化的YOLO输出解码（行格式 N×D：[cx, cy, w, h, obj, cls...]）
+ *
+ * 分两遍处理：第一遍只比较目标置信度（AVX2下一次gather 8行），
+ * 绝大多数行在这一步就被跳过；第二遍只对通过的行做向量化的类别argmax
+ * 和坐标换算。输出列表按通过的行数一次性预留容量后追加，调用方复用
+ * 这些列表时稳态下不产生堆分配。
+ *
+ * @param rows 模型输出（N×D 的float，连续存储）
+ * @param confidenceThreshold 置信度阈值（目标置信度和类别得分分别比较）
+ * @param mapping 坐标映射
+ * @param imageWidth 原图宽度
+ * @param imageHeight 原图高度
+ * @param workspace 复用的工作区
+ * @param boxes 追加的检测框
+ * @param confidences 追加的置信度（目标置信度 × 类别得分）
+ * @param classIds 追加的类别ID
+ * @return 追加的候选框数量
+ */
+size_t decodeYOLORows(const cv::Mat& rows,
+                      float confidenceThreshold,
+                      const YOLOBoxMapping& mapping,
+                      int imageWidth,
+                      int imageHeight,
+                      YOLODecodeWorkspace& workspace,
+                      std::vector<cv::Rect>& boxes,
+                      std::vector<float>& confidences,
+                      std::vector<int>& classIds);
+
+/**
+ * @brief 直接解码通道优先布局的YOLO输出（YOLOv8/v11：(4+C)×N），不做转置复制
+ *
+ * 逐个类别通道顺序扫描（每个通道在内存中连续，可整段向量化），维护每个
+ * 候选框的最高得分和类别；之后只对超过阈值的候选框按列跨度读取坐标。
+ * 这类模型没有目标置信度，输出的置信度即类别得分。
+ *
+ * @param channels 模型输出（(4+C)×N 的float，连续存储）
+ * @param confidenceThreshold 置信度阈值
+ * @param mapping 坐标映射
+ * @param imageWidth 原图宽度
+ * @param imageHeight 原图高度
+ * @param workspace 复用的工作区
+ * @param boxes 追加的检测框
+ * @param confidences 追加的置信度
+ * @param classIds 追加的类别ID
+ * @return 追加的候选框数量
+ */
+size_t decodeYOLOChannelsFirst(const cv::Mat& channels,
+                               float confidenceThreshold,
+                               const YOLOBoxMapping& mapping,
+                               int imageWidth,
+                               int imageHeight,
+                               YOLODecodeWorkspace& workspace,
+                               std::vector<cv::Rect>& boxes,
+                               std::vector<float>& confidences,
+                               std::vector<int>& classIds);
+
+/**
+ * @brief 按布局分派到对应的解码器
+ * @param output 单张图像的二维输出（逐行格式为 N×D，通道优先格式为 (4+C)×N）
+ * @param layout 输出布局
+ * 其余参数同decodeYOLORows
+ * @return 追加的候选框数量
+ */
+size_t decodeYOLOOutput(const cv::Mat& output,
+                        YOLOOutputLayout layout,
+                        float confidenceThreshold,
+                        const YOLOBoxMapping& mapping,
+                        int imageWidth,
+                        int imageHeight,
+                        YOLODecodeWorkspace& workspace,
+                        std::vector<cv::Rect>& boxes,
+                        std::vector<float>& confidences,
+                        std::vector<int>& classIds);
+
+/**
+ * @brief 解码INT8量化模型的输出（CV_8U或CV_8S），按需反量化
+ *
+ * 用256项查找表反量化。逐行格式先只查目标置信度一列筛选，通过的行才整行
+ * 反量化后复用float路径的argmax；通道优先格式逐个类别通道反量化到复用的
+ * 缓冲区，再按float路径更新最高得分。结果与先整体反量化再解码一致。
+ *
+ * @param output 单张图像的二维量化输出
+ * @param layout 输出布局
+ * @param quantization 输出张量的量化参数
+ * 其余参数同decodeYOLORows
+ * @return 追加的候选框数量
+ */
+size_t decodeYOLOQuantized(const cv::Mat& output,
+                           YOLOOutputLayout layout,
+                           const QuantizationParams& quantization,
+                           float confidenceThreshold,
+                           const YOLOBoxMapping& mapping,
+                           int imageWidth,
+                           int imageHeight,
+                           YOLODecodeWorkspace& workspace,
+                           std::vector<cv::Rect>& boxes,
+                           std::vector<float>& confidences,
+                           std::vector<int>& classIds);
+
+/**
+ * @brief 按元素类型和布局分派：float输出走decodeYOLOOutput，量化输出走decodeYOLOQuantized
+ */
+size_t decodeYOLOOutput(const cv::Mat& output,
+                        YOLOOutputLayout layout,
+                        const QuantizationParams& quantization,
+                        float confidenceThreshold,
+                        const YOLOBoxMapping& mapping,
+                        int imageWidth,
+                        int imageHeight,
+                        YOLODecodeWorkspace& workspace,
+                        std::vector<cv::Rect>& boxes,
+                        std::vector<float>& confidences,
+                        std::vector<int>& classIds);
+
+#endif // YOLO_DECODER_H
@@ -42,7 +42,7 @@ std::string Chatbot::generateResponse(const std::string& userQuery) {
     // 如果配置了智谱AI GLM-Realtime API，则使用API生成回复
     if (!zhipuAIKey.empty()) {
         std::cout << "使用智谱AI GLM-Realtime API生成回复..." << std::endl;
-        response = callZhipuAIGLMAPI(userQuery);
+        response = callZhipuAIGLMAPI(sceneContext.empty() ? userQuery : sceneContext + userQuery);
     } else {
         // 分析用户输入
         std::string analysisResult = analyzeUserInput(userQuery);
@@ -93,6 +93,10 @@ std::string Chatbot::generateResponse(const std::string& userQuery) {
     return response;
 }
 
+void Chatbot::setSceneContext(const std::string& context) {
+    sceneContext = context;
+}
+
 void Chatbot::setChatMode(ChatMode mode) {
     currentMode = mode;
     
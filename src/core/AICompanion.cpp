@@ -1,5 +1,44 @@
 #include "core/AICompanion.h"
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+// 各子系统的调度频率（Hz）和优先级（越大越优先）；ESP32上的视觉按摄像头帧率调度
+const float kImuRateHz = 100.0f;
+const float kGpsRateHz = 1.0f;
+const float kOtherSensorRateHz = 10.0f;
+const int kImuPriority = 3;
+#ifdef ESP32
+const int kVisionPriority = 2;
+#endif
+const int kGpsPriority = 1;
+const int kOtherSensorPriority = 0;
+
+bool containsId(const std::vector<int>& ids, int id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+const char* eventTypeName(EventType type) {
+    switch (type) {
+        case EventType::FenceEntered: return "进入景区";
+        case EventType::DetectionsUpdated: return "检测结果";
+        case EventType::SensorSample: return "传感器读数";
+        case EventType::UserQuery: return "用户输入";
+    }
+    return "未知";
+}
+
+const char* initStateName(InitState state) {
+    switch (state) {
+        case InitState::Pending: return "等待";
+        case InitState::Running: return "启动中";
+        case InitState::Ready: return "就绪";
+        case InitState::Failed: return "失败";
+    }
+    return "未知";
+}
+}
 
 AICompanion::AICompanion() {
     locationTracker = nullptr;
@@ -9,10 +48,26 @@ AICompanion::AICompanion() {
     sensorManager = nullptr;
     isInitialized = false;
     isDetecting = false;
+    visionStepId = -1;
+    knowledgeStepId = -1;
     
     // 景区讲解状态
     isScenicSpotExplaining = false;
     currentScenicSpot = "";
+    
+    // IMU频率高、对时序敏感，使用独占线程；其余子系统共享调度器的工作线程
+    scheduler.addTask("IMU", kImuRateHz, kImuPriority, true, [this] { updateSensorData(); });
+    scheduler.addTask("GPS", kGpsRateHz, kGpsPriority, false, [this] { updateLocation(); });
+    scheduler.addTask("其他传感器", kOtherSensorRateHz, kOtherSensorPriority, false,
+                      [this] { updateOtherSensors(); });
+#ifdef ESP32
+    // ESP32上每次update()同步采集和检测一帧；x86上由视觉流水线自己的线程采集，
+    // 结果通过DetectionsUpdatedEvent通知，不需要周期任务
+    visionTaskId = scheduler.addTask("视觉", 30.0f, kVisionPriority, false, [this] { updateVisionDetection(); });
+    scheduler.setEnabled(visionTaskId, false);   // 开始检测时启用
+#endif
+    
+    registerEventConsumers();
 }
 
 AICompanion::~AICompanion() {
@@ -34,37 +89,52 @@ bool AICompanion::initialize() {
         return false;
     }
     
-    // 初始化子系统
+    // 创建子系统，子系统之间通过事件总线通知讲解和对话
     locationTracker = new LocationTracker();
-    if (!locationTracker->initialize()) {
-        std::cerr << "位置追踪器初始化失败！" << std::endl;
-        return false;
-    }
-    
     visionProcessor = new VisionProcessor();
-    if (!visionProcessor->initialize()) {
-        std::cerr << "视觉处理器初始化失败！" << std::endl;
-        return false;
-    }
-    
     culturalGuide = new CulturalGuide();
-    if (!culturalGuide->initialize()) {
-        std::cerr << "文化讲解系统初始化失败！" << std::endl;
-        return false;
-    }
-    
     chatbot = new Chatbot();
-    if (!chatbot->initialize()) {
-        std::cerr << "聊天机器人初始化失败！" << std::endl;
-        return false;
-    }
-    
     sensorManager = new SensorManager();
-    if (!sensorManager->initialize()) {
-        std::cerr << "传感器管理器初始化失败！" << std::endl;
+    locationTracker->setEventBus(&eventBus);
+    visionProcessor->setEventBus(&eventBus);
+    sensorManager->setEventBus(&eventBus);
+    
+    // 按依赖关系并行初始化：定位依赖GPS和IMU传感器，其余子系统互不依赖。
+    // 视觉（摄像头和模型）和文化知识库在后台初始化，完成之前就可以对话和进行景区围栏讲解
+    initializer.clear();
+    const int sensorStep = initializer.addStep("传感器", {}, false, [this] {
+        return sensorManager->initialize();
+    });
+    initializer.addStep("定位", {sensorStep}, false, [this] {
+        return locationTracker->initialize();
+    });
+    initializer.addStep("对话", {}, false, [this] {
+        return chatbot->initialize();
+    });
+    visionStepId = initializer.addStep("视觉", {}, true, [this] {
+        if (!visionProcessor->initialize()) {
+            std::cerr << "视觉处理器初始化失败！" << std::endl;
+            return false;
+        }
+        return true;
+    });
+    knowledgeStepId = initializer.addStep("文化知识库", {}, true, [this] {
+        if (!culturalGuide->initialize()) {
+            std::cerr << "文化讲解系统初始化失败！" << std::endl;
+            return false;
+        }
+        return true;
+    });
+    
+    eventBus.start();
+    if (!initializer.run()) {
+        std::cerr << "子系统初始化失败！" << std::endl;
         return false;
     }
     
+    // 各子系统开始按各自的频率运行（视觉任务在开始检测时启用）
+    scheduler.start();
+    
     isInitialized = true;
     std::cout << "系统初始化完成！" << std::endl;
     return true;
@@ -78,6 +148,11 @@ void AICompanion::shutdown() {
             stopDetection();
         }
         
+        // 先停止调度，等待后台初始化结束，再停止事件消费者，之后不再有线程访问子系统
+        scheduler.stop();
+        initializer.waitAll();
+        eventBus.stop();
+        
         delete locationTracker;
         delete visionProcessor;
         delete culturalGuide;
@@ -95,64 +170,174 @@ void AICompanion::shutdown() {
     }
 }
 
-void AICompanion::update() {
-    if (!isInitialized) return;
-    
-    // 更新传感器数据
-    sensorManager->update();
+void AICompanion::updateSensorData() {
+    std::lock_guard<std::mutex> lock(sensorMutex);
+    sensorManager->update(SensorType::IMU);
+}
+
+void AICompanion::updateOtherSensors() {
+    const SensorType types[] = {
+        SensorType::CAMERA,
+        SensorType::MICROPHONE,
+        SensorType::SPEAKER,
+        SensorType::TEMPERATURE,
+        SensorType::LIGHT
+    };
+    std::lock_guard<std::mutex> lock(sensorMutex);
+    for (SensorType type : types) {
+        sensorManager->update(type);
+    }
+}
+
+void AICompanion::updateLocation() {
+    {
+        std::lock_guard<std::mutex> lock(sensorMutex);
+        sensorManager->update(SensorType::GPS);
+    }
     
-    // 更新位置信息
+    // 更新位置信息；进入新景区时LocationTracker发布事件，由讲解消费者开始讲解
+    std::lock_guard<std::mutex> lock(locationMutex);
     locationTracker->update();
+}
+
+#ifdef ESP32
+void AICompanion::updateVisionDetection() {
+    std::lock_guard<std::mutex> lock(visionMutex);
+    if (!isDetecting) return;
     
-    // 检查是否进入新景区并开始讲解
-    checkScenicSpotEntry();
+    visionProcessor->update();
+}
+#endif
+
+void AICompanion::registerEventConsumers() {
+    // 讲解：进入新景区时介绍景区，有新的检测结果时讲解新出现的目标
+    const int narration = eventBus.addConsumer("讲解");
+    eventBus.subscribe<FenceEnteredEvent>(narration, [this](const FenceEnteredEvent& event) {
+        onFenceEntered(event);
+    });
+    eventBus.subscribe<DetectionsUpdatedEvent>(narration, [this](const DetectionsUpdatedEvent& event) {
+        onDetectionsUpdated(event);
+    });
     
-    // 如果正在检测，更新视觉处理
-    if (isDetecting) {
-        visionProcessor->update();
-        
-        // 获取识别结果
-        std::vector<std::string> detectedObjects = visionProcessor->getDetectedObjects();
-        
-        // 对于检测到的对象，提供文化讲解
-        for (const auto& object : detectedObjects) {
-            std::string explanation = culturalGuide->getExplanation(object);
-            if (!explanation.empty()) {
-                std::cout << "文化讲解: " << explanation << std::endl;
+    // 对话：回复用户输入，记住所在景区作为对话的上下文
+    const int chat = eventBus.addConsumer("对话");
+    eventBus.subscribe<UserQueryEvent>(chat, [this](const UserQueryEvent& event) {
+        onUserQuery(event);
+    });
+    eventBus.subscribe<FenceEnteredEvent>(chat, [this](const FenceEnteredEvent& event) {
+        updateChatContext(event);
+    });
+    
+    // 日志（设置AICOMPANION_EVENT_LOG时启用）：记录各子系统的事件，传感器只记录无效读数
+    if (std::getenv("AICOMPANION_EVENT_LOG")) {
+        const int log = eventBus.addConsumer("日志");
+        eventBus.subscribe<FenceEnteredEvent>(log, [](const FenceEnteredEvent& event) {
+            std::clog << "[事件] 进入景区 " << event.scenicSpot << " (" << event.latitude << ", "
+                      << event.longitude << ")" << std::endl;
+        });
+        eventBus.subscribe<DetectionsUpdatedEvent>(log, [](const DetectionsUpdatedEvent& event) {
+            std::clog << "[事件] 摄像头" << event.cameraId << " 帧" << event.frameId << " 检测到 "
+                      << event.detectionCount << " 个目标" << std::endl;
+        });
+        eventBus.subscribe<SensorSampleEvent>(log, [](const SensorSampleEvent& event) {
+            if (!event.isValid) {
+                std::clog << "[事件] 传感器" << static_cast<int>(event.type) << " 读数无效" << std::endl;
             }
-        }
+        });
+        eventBus.subscribe<UserQueryEvent>(log, [](const UserQueryEvent& event) {
+            std::clog << "[事件] 用户输入: " << event.query << std::endl;
+        });
     }
 }
 
-// 检查是否进入新景区并开始讲解
-void AICompanion::checkScenicSpotEntry() {
-    if (locationTracker->hasEnteredNewScenicSpot()) {
-        std::string newScenicSpot = locationTracker->getCurrentScenicSpot();
-        
-        std::cout << "欢迎来到" << newScenicSpot << "！" << std::endl;
+void AICompanion::onDetectionsUpdated(const DetectionsUpdatedEvent& event) {
+    // 讲解只跟随主摄像头；知识库还没有就绪时先不讲解，目标在画面中时稍后还会讲解
+    if (event.cameraId != 0 || !initializer.isReady(knowledgeStepId)) return;
+    
+    std::lock_guard<std::mutex> lock(visionMutex);
+    if (!isDetecting) return;
+    
+    // 获取最新识别结果的只读视图（带跟踪ID和标签ID），不复制结果
+    DetectionView detections = visionProcessor->getDetections();
+    
+    // 只为新出现的目标提供文化讲解，同一目标停留在画面中时不再重复讲解
+    visibleTracks.clear();
+    visibleLabels.clear();
+    for (const auto& object : detections) {
+        const bool tracked = object.trackId >= 0;
+        std::vector<int>& visible = tracked ? visibleTracks : visibleLabels;
+        const std::vector<int>& explained = tracked ? explainedTracks : explainedLabels;
+        const int id = tracked ? object.trackId : object.labelId;
+        if (containsId(visible, id)) {
+            continue;
+        }
+        visible.push_back(id);
+        if (containsId(explained, id)) {
+            continue;
+        }
         
-        // 获取并显示景区介绍
-        std::vector<CulturalInfo> scenicSpotInfo = culturalGuide->getLocationInfo(newScenicSpot);
-        if (!scenicSpotInfo.empty()) {
-            std::cout << "景区介绍：" << std::endl;
-            for (const auto& info : scenicSpotInfo) {
-                if (!info.title.empty()) {
-                    std::cout << "- " << info.title << "：" << info.description << std::endl;
-                }
+        std::string explanation = culturalGuide->getExplanation(visionProcessor->getLabelName(object.labelId));
+        if (!explanation.empty()) {
+            std::cout << "文化讲解: " << explanation << std::endl;
+        }
+    }
+    
+    // 离开画面的目标从记录中移除，再次出现时会重新讲解
+    explainedTracks.swap(visibleTracks);
+    explainedLabels.swap(visibleLabels);
+    
+    // 碑文、书法作品识别出文字后，以文字为关键词补充讲解（每块碑在画面中期间讲解一次）
+    visionProcessor->getRecognizedInscriptions(inscriptions);
+    visibleInscriptions.clear();
+    for (const auto& inscription : inscriptions) {
+        visibleInscriptions.push_back(inscription.trackId);
+        if (containsId(explainedInscriptions, inscription.trackId)) {
+            continue;
+        }
+        std::cout << "识别出" << visionProcessor->getLabelName(inscription.labelId) << "上的文字: "
+                  << inscription.text << std::endl;
+        std::string explanation = culturalGuide->getExplanationForText(inscription.text);
+        if (!explanation.empty()) {
+            std::cout << "文化讲解: " << explanation << std::endl;
+        }
+    }
+    explainedInscriptions.swap(visibleInscriptions);
+}
+
+// 进入新景区时开始讲解
+void AICompanion::onFenceEntered(const FenceEnteredEvent& event) {
+    // 知识库在后台加载，讲解前等待加载完成（只阻塞讲解消费者的线程）
+    if (!initializer.waitFor(knowledgeStepId)) {
+        std::cout << "欢迎来到" << event.scenicSpot << "！" << std::endl;
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(locationMutex);
+    const std::string& newScenicSpot = event.scenicSpot;
+    
+    std::cout << "欢迎来到" << newScenicSpot << "！" << std::endl;
+    
+    // 获取并显示景区介绍
+    std::vector<CulturalInfo> scenicSpotInfo = culturalGuide->getLocationInfo(newScenicSpot);
+    if (!scenicSpotInfo.empty()) {
+        std::cout << "景区介绍：" << std::endl;
+        for (const auto& info : scenicSpotInfo) {
+            if (!info.title.empty()) {
+                std::cout << "- " << info.title << "：" << info.description << std::endl;
             }
-        } else {
-            std::cout << "正在为您介绍" << newScenicSpot << "的相关文化知识..." << std::endl;
         }
-        
-        // 设置当前景区
-        currentScenicSpot = newScenicSpot;
-        
-        // 标记正在进行景区讲解
-        isScenicSpotExplaining = true;
-        
-        // 自动开始景区文化讲解
-        startScenicSpotExplanation();
+    } else {
+        std::cout << "正在为您介绍" << newScenicSpot << "的相关文化知识..." << std::endl;
     }
+    
+    // 设置当前景区
+    currentScenicSpot = newScenicSpot;
+    
+    // 标记正在进行景区讲解
+    isScenicSpotExplaining = true;
+    
+    // 自动开始景区文化讲解
+    startScenicSpotExplanation();
 }
 
 // 开始景区文化讲解
@@ -194,6 +379,7 @@ void AICompanion::startScenicSpotExplanation() {
 
 // 中断当前的景区讲解
 void AICompanion::interruptScenicSpotExplanation() {
+    std::lock_guard<std::mutex> lock(locationMutex);
     if (isScenicSpotExplaining) {
         isScenicSpotExplaining = false;
         std::cout << "景区讲解已暂停。" << std::endl;
@@ -203,6 +389,7 @@ void AICompanion::interruptScenicSpotExplanation() {
 void AICompanion::getCurrentLocation() {
     if (!isInitialized) return;
     
+    std::lock_guard<std::mutex> lock(locationMutex);
     LocationInfo location = locationTracker->getCurrentLocation();
     std::cout << "当前位置: " << location.latitude << ", " << location.longitude << std::endl;
     std::cout << "精度: " << location.accuracy << " 米" << std::endl;
@@ -212,16 +399,41 @@ void AICompanion::getCurrentLocation() {
 void AICompanion::startDetection() {
     if (!isInitialized) return;
     
-    visionProcessor->start();
-    isDetecting = true;
+    // 视觉在后台初始化，完成前不能开始检测
+    const InitState visionState = initializer.getState(visionStepId);
+    if (visionState != InitState::Ready) {
+        std::cout << (visionState == InitState::Failed ? "视觉系统不可用！" : "视觉系统正在启动，请稍后再试。")
+                  << std::endl;
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(visionMutex);
+        visionProcessor->start();
+        isDetecting = true;
+    }
+#ifdef ESP32
+    // 视觉任务按摄像头帧率运行
+    scheduler.setRate(visionTaskId, visionProcessor->getCameraFrameRate());
+    scheduler.setEnabled(visionTaskId, true);
+#endif
     std::cout << "开始视觉检测和识别..." << std::endl;
 }
 
 void AICompanion::stopDetection() {
-    if (!isInitialized) return;
+    if (!isInitialized || !initializer.isReady(visionStepId)) return;
     
-    visionProcessor->stop();
-    isDetecting = false;
+#ifdef ESP32
+    scheduler.setEnabled(visionTaskId, false);
+#endif
+    {
+        std::lock_guard<std::mutex> lock(visionMutex);
+        visionProcessor->stop();
+        isDetecting = false;
+        explainedTracks.clear();
+        explainedLabels.clear();
+        explainedInscriptions.clear();
+    }
     std::cout << "停止视觉检测和识别..." << std::endl;
 }
 
@@ -239,6 +451,7 @@ void AICompanion::reset() {
     }
     
     // 重置景区讲解状态
+    std::lock_guard<std::mutex> lock(locationMutex);
     isScenicSpotExplaining = false;
     currentScenicSpot = "";
 }
@@ -252,25 +465,41 @@ void AICompanion::processUserQuery(const std::string& query) {
         std::cout << std::endl;
     }
     
-    std::string response = chatbot->generateResponse(query);
+    // 回复由对话消费者在自己的线程中生成（可能需要请求大模型API），不阻塞命令处理
+    UserQueryEvent event;
+    event.query = query;
+    eventBus.publish(event);
+}
+
+void AICompanion::onUserQuery(const UserQueryEvent& event) {
+    std::lock_guard<std::mutex> lock(chatMutex);
+    std::string response = chatbot->generateResponse(event.query);
     std::cout << "AI伴游: " << response << std::endl;
 }
 
+void AICompanion::updateChatContext(const FenceEnteredEvent& event) {
+    std::lock_guard<std::mutex> lock(chatMutex);
+    chatbot->setSceneContext("（我现在在" + event.scenicSpot + "）");
+}
+
 void AICompanion::setChatMode(ChatMode mode) {
     if (!isInitialized || chatbot == nullptr) return;
     
+    std::lock_guard<std::mutex> lock(chatMutex);
     chatbot->setChatMode(mode);
 }
 
 bool AICompanion::setupZhipuAIGLMAPI(const std::string& apiKey, const std::string& model) {
     if (!isInitialized || chatbot == nullptr) return false;
     
+    std::lock_guard<std::mutex> lock(chatMutex);
     return chatbot->setupZhipuAIGLMAPI(apiKey, model);
 }
 
 bool AICompanion::setupAmapAPI(const std::string& apiKey) {
     if (!isInitialized || locationTracker == nullptr) return false;
     
+    std::lock_guard<std::mutex> lock(locationMutex);
     return locationTracker->setupAmapAPI(apiKey);
 }
 
@@ -299,12 +528,56 @@ void AICompanion::showStatus() {
     std::cout << "  检测状态: " << (isDetecting ? "正在检测" : "未检测") << std::endl;
     
     // 显示GPS状态
-    bool gpsAvailable = locationTracker->isGPSAvailable();
+    bool gpsAvailable;
+    {
+        std::lock_guard<std::mutex> lock(locationMutex);
+        gpsAvailable = locationTracker->isGPSAvailable();
+    }
     std::cout << "  GPS状态: " << (gpsAvailable ? "可用" : "不可用") << std::endl;
     
-    // 显示摄像头状态
-    bool cameraAvailable = visionProcessor->isCameraAvailable();
-    std::cout << "  摄像头状态: " << (cameraAvailable ? "可用" : "不可用") << std::endl;
+    // 显示各子系统的启动状态（后台初始化的子系统可能还没有就绪）
+    std::cout << "  子系统启动:" << std::endl;
+    for (const auto& step : initializer.getStatus()) {
+        std::cout << "    " << step.name << ": " << initStateName(step.state)
+                  << (step.background ? "（后台）" : "");
+        if (step.state != InitState::Pending) {
+            std::cout << "，" << static_cast<int>(step.elapsedMs) << " ms";
+        }
+        std::cout << std::endl;
+    }
+    
+    if (initializer.isReady(visionStepId)) {
+        // 显示摄像头和检测模型状态
+        bool cameraAvailable = visionProcessor->isCameraAvailable();
+        std::cout << "  摄像头状态: " << (cameraAvailable ? "可用" : "不可用") << std::endl;
+        std::cout << "  检测模型: "
+                  << (visionProcessor->isModelLoading() ? "加载中"
+                      : visionProcessor->isModelReady() ? "就绪" : "未加载（模拟模式）")
+                  << std::endl;
+        
+        // 显示因画面未变化而跳过推理的比例
+        std::cout << "  推理跳过率: " << static_cast<int>(visionProcessor->getInferenceSkipRatio() * 100.0f)
+                  << "%" << std::endl;
+    }
+    
+    // 显示各子系统的调度情况（超时次数、跳过的周期和开始时间的抖动）
+    std::cout << "  子系统调度:" << std::endl;
+    for (const auto& task : scheduler.getStats()) {
+        std::cout << "    " << task.name << ": " << task.rateHz << " Hz"
+                  << (task.dedicatedThread ? "（独占线程）" : "")
+                  << "，运行 " << task.runs << " 次，超时 " << task.overruns << " 次，跳过周期 "
+                  << task.missedReleases << " 个，抖动 平均 " << task.meanJitterMs << " ms / 最大 "
+                  << task.maxJitterMs << " ms，耗时 平均 " << task.meanRunMs << " ms / 最大 "
+                  << task.maxRunMs << " ms" << std::endl;
+    }
+    
+    // 显示事件总线各订阅的投递情况
+    std::cout << "  事件总线:" << std::endl;
+    for (const auto& subscription : eventBus.getStats()) {
+        std::cout << "    " << subscription.consumer << "/" << eventTypeName(subscription.type)
+                  << ": 处理 " << subscription.delivered << " 个，丢弃 " << subscription.dropped << " 个"
+                  << std::endl;
+    }
 }
 
 bool AICompanion::detectDeviceType() {
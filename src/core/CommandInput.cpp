@@ -0,0 +1,35 @@
+#include "core/CommandInput.h"
+#include <iostream>
+
+CommandInput::CommandInput() : commands(kQueueCapacity) {}
+
+CommandInput::~CommandInput() {
+    commands.close();
+    if (reader.joinable()) {
+        reader.join();
+    }
+}
+
+void CommandInput::start() {
+    if (reader.joinable()) {
+        return;
+    }
+    reader = std::thread(&CommandInput::readLoop, this);
+}
+
+bool CommandInput::nextCommand(std::string& command) {
+    return commands.pop(command);
+}
+
+void CommandInput::readLoop() {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!commands.pushWait(line)) {
+            return;   // 队列已关闭
+        }
+        if (line == "exit" || line == "quit") {
+            break;
+        }
+    }
+    commands.close();
+}
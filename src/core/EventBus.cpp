@@ -0,0 +1,106 @@
+#include "core/EventBus.h"
+#include <iostream>
+#include <exception>
+
+EventBus::EventBus(size_t queueCapacity) : queueCapacity(queueCapacity > 0 ? queueCapacity : 1), running(false) {}
+
+EventBus::~EventBus() {
+    stop();
+}
+
+int EventBus::addConsumer(const std::string& name) {
+    if (running) {
+        std::cerr << "事件总线运行中，不能注册消费者: " << name << std::endl;
+        return -1;
+    }
+    std::unique_ptr<Consumer> consumer(new Consumer());
+    consumer->name = name;
+    consumers.push_back(std::move(consumer));
+    return static_cast<int>(consumers.size() - 1);
+}
+
+void EventBus::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    for (auto& consumer : consumers) {
+        consumer->thread = std::thread(&EventBus::consumerLoop, this, consumer.get());
+    }
+}
+
+void EventBus::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    for (auto& consumer : consumers) {
+        {
+            std::lock_guard<std::mutex> lock(consumer->mutex);
+            consumer->sleeping = false;
+        }
+        consumer->wake.notify_one();
+    }
+    for (auto& consumer : consumers) {
+        if (consumer->thread.joinable()) {
+            consumer->thread.join();
+        }
+    }
+}
+
+std::vector<EventSubscriptionStats> EventBus::getStats() const {
+    std::vector<EventSubscriptionStats> result;
+    for (const auto& subscription : subscriptions) {
+        EventSubscriptionStats stats;
+        stats.consumer = subscription->consumer->name;
+        stats.type = subscription->type;
+        stats.delivered = subscription->delivered.load(std::memory_order_relaxed);
+        stats.dropped = subscription->dropped.load(std::memory_order_relaxed);
+        result.push_back(stats);
+    }
+    return result;
+}
+
+void EventBus::consumerLoop(Consumer* consumer) {
+    while (running) {
+        // 轮流处理各订阅队列中的事件，直到所有队列都为空
+        bool dispatched = false;
+        for (SubscriptionBase* subscription : consumer->subscriptions) {
+            try {
+                dispatched = subscription->dispatchOne() || dispatched;
+            } catch (const std::exception& e) {
+                std::cerr << "事件处理出错（" << consumer->name << "）: " << e.what() << std::endl;
+                dispatched = true;
+            }
+        }
+        if (dispatched) {
+            continue;
+        }
+
+        // 先标记为等待，再检查一次队列：生产者在标记之后入队的事件一定会唤醒消费者
+        std::unique_lock<std::mutex> lock(consumer->mutex);
+        consumer->sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool pending = false;
+        for (SubscriptionBase* subscription : consumer->subscriptions) {
+            pending = pending || subscription->pending();
+        }
+        if (pending || !running) {
+            consumer->sleeping.store(false);
+            continue;
+        }
+        consumer->wake.wait(lock, [consumer] { return !consumer->sleeping.load(); });
+    }
+}
+
+void EventBus::notify(Consumer& consumer) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!consumer.sleeping.exchange(false)) {
+        return;   // 消费者正在处理事件，会在等待之前看到新事件
+    }
+    {
+        // 等消费者进入wait()后再通知，避免通知丢失
+        std::lock_guard<std::mutex> lock(consumer.mutex);
+    }
+    consumer.wake.notify_one();
+}
@@ -0,0 +1,148 @@
+#include "core/SubsystemInitializer.h"
+#include <iostream>
+#include <exception>
+
+SubsystemInitializer::SubsystemInitializer() : started(false) {}
+
+SubsystemInitializer::~SubsystemInitializer() {
+    waitAll();
+}
+
+int SubsystemInitializer::addStep(const std::string& name, const std::vector<int>& dependencies, bool background,
+                                  const Step& step) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (started || !step) {
+        std::cerr << "无法注册初始化步骤: " << name << std::endl;
+        return -1;
+    }
+    // 只能依赖之前注册的步骤，因此不会出现循环依赖
+    for (int dependency : dependencies) {
+        if (dependency < 0 || static_cast<size_t>(dependency) >= steps.size()) {
+            std::cerr << "初始化步骤的依赖无效: " << name << std::endl;
+            return -1;
+        }
+    }
+
+    StepState state;
+    state.name = name;
+    state.dependencies = dependencies;
+    state.background = background;
+    state.step = step;
+    steps.push_back(state);
+    return static_cast<int>(steps.size() - 1);
+}
+
+bool SubsystemInitializer::run() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (started) {
+            return false;
+        }
+        started = true;
+        for (size_t i = 0; i < steps.size(); ++i) {
+            threads.push_back(std::thread(&SubsystemInitializer::runStep, this, i));
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    bool success = true;
+    for (const auto& step : steps) {
+        if (step.background) {
+            continue;
+        }
+        changed.wait(lock, [&step] { return finished(step.state); });
+        success = success && step.state == InitState::Ready;
+    }
+    return success;
+}
+
+void SubsystemInitializer::waitAll() {
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+bool SubsystemInitializer::waitFor(int stepId) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stepId < 0 || static_cast<size_t>(stepId) >= steps.size() || !started) {
+        return false;
+    }
+    const StepState& step = steps[static_cast<size_t>(stepId)];
+    changed.wait(lock, [&step] { return finished(step.state); });
+    return step.state == InitState::Ready;
+}
+
+bool SubsystemInitializer::isReady(int stepId) const {
+    return getState(stepId) == InitState::Ready;
+}
+
+InitState SubsystemInitializer::getState(int stepId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stepId < 0 || static_cast<size_t>(stepId) >= steps.size()) {
+        return InitState::Failed;
+    }
+    return steps[static_cast<size_t>(stepId)].state;
+}
+
+std::vector<InitStepStatus> SubsystemInitializer::getStatus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Clock::time_point now = Clock::now();
+    std::vector<InitStepStatus> result;
+    for (const auto& step : steps) {
+        InitStepStatus status;
+        status.name = step.name;
+        status.state = step.state;
+        status.background = step.background;
+        if (step.state != InitState::Pending && step.startTime != Clock::time_point()) {
+            const Clock::time_point end = finished(step.state) ? step.endTime : now;
+            status.elapsedMs = std::chrono::duration<double, std::milli>(end - step.startTime).count();
+        }
+        result.push_back(status);
+    }
+    return result;
+}
+
+void SubsystemInitializer::clear() {
+    waitAll();
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.clear();
+    steps.clear();
+    started = false;
+}
+
+void SubsystemInitializer::runStep(size_t index) {
+    std::unique_lock<std::mutex> lock(mutex);
+    StepState& step = steps[index];
+
+    // 等待依赖的步骤结束
+    bool dependenciesReady = true;
+    for (int dependency : step.dependencies) {
+        const StepState& required = steps[static_cast<size_t>(dependency)];
+        changed.wait(lock, [&required] { return finished(required.state); });
+        dependenciesReady = dependenciesReady && required.state == InitState::Ready;
+    }
+
+    if (dependenciesReady) {
+        step.state = InitState::Running;
+        step.startTime = Clock::now();
+        lock.unlock();
+
+        bool success = false;
+        try {
+            success = step.step();
+        } catch (const std::exception& e) {
+            std::cerr << "初始化 " << step.name << " 出错: " << e.what() << std::endl;
+        }
+
+        lock.lock();
+        step.endTime = Clock::now();
+        step.state = success ? InitState::Ready : InitState::Failed;
+    } else {
+        std::cerr << "依赖的子系统初始化失败，跳过: " << step.name << std::endl;
+        step.state = InitState::Failed;
+    }
+    lock.unlock();
+    changed.notify_all();
+}
@@ -0,0 +1,244 @@
+#include "core/SubsystemScheduler.h"
+#include <iostream>
+#include <algorithm>
+#include <exception>
+
+namespace {
+// 同一任务两次超时警告之间的最短间隔
+const std::chrono::seconds kOverrunWarningInterval(1);
+
+double toMilliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::chrono::steady_clock::duration periodForRate(float rateHz) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / rateHz));
+}
+} // namespace
+
+SubsystemScheduler::SubsystemScheduler(size_t pooledThreads)
+    : pooledThreadCount(std::max<size_t>(1, pooledThreads)), running(false) {}
+
+SubsystemScheduler::~SubsystemScheduler() {
+    stop();
+}
+
+int SubsystemScheduler::addTask(const std::string& name, float rateHz, int priority, bool dedicatedThread,
+                                const Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        std::cerr << "调度器运行中，不能注册任务: " << name << std::endl;
+        return -1;
+    }
+    if (!(rateHz > 0.0f) || !task) {
+        std::cerr << "任务的频率无效: " << name << std::endl;
+        return -1;
+    }
+
+    std::unique_ptr<TaskState> state(new TaskState());
+    state->name = name;
+    state->task = task;
+    state->priority = priority;
+    state->dedicated = dedicatedThread;
+    state->period = periodForRate(rateHz);
+    state->stats.name = name;
+    state->stats.rateHz = rateHz;
+    state->stats.priority = priority;
+    state->stats.dedicatedThread = dedicatedThread;
+    tasks.push_back(std::move(state));
+    return static_cast<int>(tasks.size() - 1);
+}
+
+bool SubsystemScheduler::setRate(int taskId, float rateHz) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (taskId < 0 || static_cast<size_t>(taskId) >= tasks.size() || !(rateHz > 0.0f)) {
+            return false;
+        }
+        TaskState& task = *tasks[static_cast<size_t>(taskId)];
+        task.period = periodForRate(rateHz);
+        task.stats.rateHz = rateHz;
+        // 新周期更短时不必等到原来的下一个节拍
+        const Clock::time_point soonest = Clock::now() + task.period;
+        if (task.nextRelease > soonest) {
+            task.nextRelease = soonest;
+        }
+    }
+    wake.notify_all();
+    return true;
+}
+
+void SubsystemScheduler::setEnabled(int taskId, bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (taskId < 0 || static_cast<size_t>(taskId) >= tasks.size()) {
+            return;
+        }
+        TaskState& task = *tasks[static_cast<size_t>(taskId)];
+        if (enabled && !task.enabled) {
+            task.nextRelease = Clock::now();
+        }
+        task.enabled = enabled;
+    }
+    wake.notify_all();
+}
+
+void SubsystemScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+    running = true;
+
+    const Clock::time_point now = Clock::now();
+    size_t pooledTasks = 0;
+    for (auto& task : tasks) {
+        task->nextRelease = now;
+        if (task->dedicated) {
+            threads.push_back(std::thread(&SubsystemScheduler::dedicatedLoop, this, task.get()));
+        } else {
+            ++pooledTasks;
+        }
+    }
+    // 共享线程比共享任务多没有意义
+    for (size_t i = 0; i < std::min(pooledThreadCount, pooledTasks); ++i) {
+        threads.push_back(std::thread(&SubsystemScheduler::poolLoop, this));
+    }
+}
+
+void SubsystemScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads.clear();
+}
+
+bool SubsystemScheduler::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return running;
+}
+
+std::vector<ScheduledTaskStats> SubsystemScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ScheduledTaskStats> result;
+    for (const auto& task : tasks) {
+        ScheduledTaskStats stats = task->stats;
+        if (stats.runs > 0) {
+            stats.meanJitterMs = task->jitterSumMs / stats.runs;
+            stats.meanRunMs = task->runSumMs / stats.runs;
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+void SubsystemScheduler::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& task : tasks) {
+        ScheduledTaskStats& stats = task->stats;
+        stats.runs = 0;
+        stats.overruns = 0;
+        stats.missedReleases = 0;
+        stats.maxJitterMs = 0.0;
+        stats.maxRunMs = 0.0;
+        task->jitterSumMs = 0.0;
+        task->runSumMs = 0.0;
+    }
+}
+
+void SubsystemScheduler::poolLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        const Clock::time_point now = Clock::now();
+        TaskState* due = nullptr;
+        Clock::time_point earliest = Clock::time_point::max();
+        for (auto& task : tasks) {
+            if (task->dedicated || !task->enabled || task->active) {
+                continue;
+            }
+            if (task->nextRelease > now) {
+                earliest = std::min(earliest, task->nextRelease);
+            } else if (!due || task->priority > due->priority ||
+                       (task->priority == due->priority && task->nextRelease < due->nextRelease)) {
+                due = task.get();
+            }
+        }
+
+        if (due) {
+            runTask(*due, lock);
+        } else if (earliest == Clock::time_point::max()) {
+            wake.wait(lock);
+        } else {
+            wake.wait_until(lock, earliest);
+        }
+    }
+}
+
+void SubsystemScheduler::dedicatedLoop(TaskState* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        if (!task->enabled) {
+            wake.wait(lock);
+        } else if (Clock::now() < task->nextRelease) {
+            wake.wait_until(lock, task->nextRelease);
+        } else {
+            runTask(*task, lock);
+        }
+    }
+}
+
+void SubsystemScheduler::runTask(TaskState& task, std::unique_lock<std::mutex>& lock) {
+    const Clock::time_point release = task.nextRelease;
+    task.active = true;
+    lock.unlock();
+
+    const Clock::time_point start = Clock::now();
+    try {
+        task.task();
+    } catch (const std::exception& e) {
+        std::cerr << "任务 " << task.name << " 运行出错: " << e.what() << std::endl;
+    }
+    const Clock::time_point end = Clock::now();
+
+    lock.lock();
+    task.active = false;
+
+    ScheduledTaskStats& stats = task.stats;
+    const double jitterMs = toMilliseconds(start - release);
+    const double runMs = toMilliseconds(end - start);
+    ++stats.runs;
+    task.jitterSumMs += jitterMs;
+    task.runSumMs += runMs;
+    stats.maxJitterMs = std::max(stats.maxJitterMs, jitterMs);
+    stats.maxRunMs = std::max(stats.maxRunMs, runMs);
+
+    // 下一个节拍：跳过运行期间已经错过的节拍，不补跑
+    const Clock::duration period = task.period;
+    const Clock::rep elapsed = (end - release) / period;
+    task.nextRelease = release + period * (elapsed + 1);
+    stats.missedReleases += static_cast<size_t>(elapsed);
+
+    if (end - start > period) {
+        ++stats.overruns;
+        if (end - task.lastOverrunWarning >= kOverrunWarningInterval) {
+            task.lastOverrunWarning = end;
+            std::cerr << "任务 " << task.name << " 超时: 运行 " << runMs << " ms，周期 " << toMilliseconds(period)
+                      << " ms（累计 " << stats.overruns << " 次）" << std::endl;
+        }
+    }
+    // 其他共享线程在计算等待时间时跳过了正在运行的任务，需要重新计算
+    if (!task.dedicated) {
+        wake.notify_all();
+    }
+}
@@ -40,6 +40,48 @@ std::string CulturalGuide::getExplanation(const std::string& objectName) {
     }
 }
 
+std::string CulturalGuide::getExplanationForText(const std::string& text) {
+    if (text.empty()) {
+        return "";
+    }
+    
+    // 识别结果常常多出或缺少几个字，取文字中出现的最长的对象名称或标题
+    const CulturalInfo* best = nullptr;
+    size_t bestLength = 0;
+    for (const auto& pair : knowledgeBase) {
+        for (const auto& info : pair.second) {
+            const std::string* keys[] = {&pair.first, &info.title};
+            for (const std::string* key : keys) {
+                if (key->size() > bestLength && text.find(*key) != std::string::npos) {
+                    best = &info;
+                    bestLength = key->size();
+                }
+            }
+        }
+    }
+    
+    // 文字只是标题的一部分时（例如只识别出碑额），在标题中查找；至少两个汉字才查找，避免误匹配
+    const size_t kMinKeywordBytes = 6;
+    if (!best && text.size() >= kMinKeywordBytes) {
+        for (const auto& pair : knowledgeBase) {
+            for (const auto& info : pair.second) {
+                if (info.title.find(text) != std::string::npos) {
+                    best = &info;
+                    break;
+                }
+            }
+            if (best) {
+                break;
+            }
+        }
+    }
+    
+    if (!best) {
+        return "";
+    }
+    return best->title + ": " + best->description;
+}
+
 std::vector<CulturalInfo> CulturalGuide::getLocationInfo(const std::string& locationName) {
     // 检查位置是否在知识库中
     auto it = locationKnowledge.find(locationName);
@@ -144,6 +186,31 @@ void CulturalGuide::initializeDefaultKnowledge() {
     info.significance = "碑文为我们提供了珍贵的第一手历史资料，对于还原古代社会具有不可替代的作用。";
     knowledgeBase["碑文"].push_back(info);
     
+    // 著名碑帖（识别出碑文、书法作品上的文字后按文字查找）
+    info.title = "兰亭集序";
+    info.description = "《兰亭集序》是东晋书法家王羲之的行书代表作，记述了兰亭雅集的盛况，被誉为“天下第一行书”。";
+    info.history = "东晋永和九年（353年），王羲之与友人在会稽山阴的兰亭修禊，写下此序；真迹相传随唐太宗葬入昭陵，今存冯承素摹本等唐摹本。";
+    info.significance = "《兰亭集序》笔法遒媚、结字多变，是历代书家学习行书的范本。";
+    knowledgeBase["兰亭集序"].push_back(info);
+    
+    info.title = "九成宫醴泉铭";
+    info.description = "《九成宫醴泉铭》由魏徵撰文、欧阳询书写，是唐代楷书的代表作。";
+    info.history = "此碑刻于唐贞观六年（632年），记述唐太宗在九成宫避暑时发现醴泉之事，原碑在今陕西麟游。";
+    info.significance = "此碑法度严谨、结体险峻，被誉为“楷书极则”，是学习欧体楷书的经典范本。";
+    knowledgeBase["九成宫醴泉铭"].push_back(info);
+    
+    info.title = "多宝塔碑";
+    info.description = "《多宝塔碑》由岑勋撰文、颜真卿书写，是颜真卿早期楷书的代表作。";
+    info.history = "此碑刻于唐天宝十一年（752年），记述西京千福寺楚金禅师建造多宝塔的经过，现藏西安碑林博物馆。";
+    info.significance = "此碑用笔丰腴、结构严密，是学习颜体楷书的入门范本。";
+    knowledgeBase["多宝塔碑"].push_back(info);
+    
+    info.title = "石鼓文";
+    info.description = "石鼓文是刻在十块鼓形石上的先秦秦国文字，内容为记述游猎的四言诗。";
+    info.history = "石鼓于唐代初年在陕西凤翔一带被发现，历经辗转，现藏故宫博物院。";
+    info.significance = "石鼓文是现存最早的石刻文字之一，上承金文、下启小篆，对研究汉字演变和书法史具有重要价值。";
+    knowledgeBase["石鼓文"].push_back(info);
+    
     // 瓷器展品
     info.title = "瓷器的艺术魅力";
     info.description = "瓷器是中国古代的伟大发明之一，以其精湛的工艺和独特的艺术风格闻名于世。";
@@ -2,10 +2,18 @@
 #include <iostream>
 #include <cmath>
 #include "location/AmapAPI.h"
+#include "core/EventBus.h"
+
+namespace {
+// 模拟定位时在每个示例位置停留的定位次数（按1Hz定位约30秒）
+const int kFixesPerSampleLocation = 30;
+}
 
 LocationTracker::LocationTracker() {
     gpsAvailable = false;
     imuAvailable = false;
+    simulatedFixCount = 0;
+    eventBus = nullptr;
     
     // 初始化位置信息
     currentLocation.latitude = 0.0;
@@ -105,6 +113,7 @@ void LocationTracker::reset() {
     // 重置电子围栏相关状态
     currentScenicSpot = "";
     lastScenicSpot = "";
+    simulatedFixCount = 0;
     
     std::cout << "位置追踪系统已重置" << std::endl;
 }
@@ -140,52 +149,64 @@ void LocationTracker::update() {
     // 保存当前景区作为上一次景区
     lastScenicSpot = currentScenicSpot;
     
-    // 模拟位置更新
-    static int count = 0;
-    count++;
-    
-    // 每10次更新模拟一个有效的位置
-    if (count % 10 == 0) {
-        // 模拟一些示例位置（例如博物馆）
-        const double sampleLocations[5][2] = {
-            {39.9042, 116.4074}, // 故宫博物院
-            {39.9139, 116.3912}, // 天坛公园
-            {34.2657, 108.9542}, // 兵马俑博物馆
-            {30.2741, 120.1551}, // 杭州西湖
-            {22.5431, 114.0579}  // 深圳世界之窗
-        };
-        
-        int index = count / 10 % 5;
-        currentLocation.latitude = sampleLocations[index][0];
-        currentLocation.longitude = sampleLocations[index][1];
-        currentLocation.altitude = 50.0 + (rand() % 100);
-        currentLocation.accuracy = 5.0 + (rand() % 20) / 10.0;
-        currentLocation.isValid = true;
-        
-        // 反向地理编码
+    // 模拟定位：每次调用得到一个有效位置，在每个示例位置停留kFixesPerSampleLocation次定位
+    ++simulatedFixCount;
+    
+    // 模拟一些示例位置（例如博物馆）
+    const double sampleLocations[5][2] = {
+        {39.9042, 116.4074}, // 故宫博物院
+        {39.9139, 116.3912}, // 天坛公园
+        {34.2657, 108.9542}, // 兵马俑博物馆
+        {30.2741, 120.1551}, // 杭州西湖
+        {22.5431, 114.0579}  // 深圳世界之窗
+    };
+    
+    int index = simulatedFixCount / kFixesPerSampleLocation % 5;
+    currentLocation.latitude = sampleLocations[index][0];
+    currentLocation.longitude = sampleLocations[index][1];
+    currentLocation.altitude = 50.0 + (rand() % 100);
+    currentLocation.accuracy = 5.0 + (rand() % 20) / 10.0;
+    currentLocation.isValid = true;
+    
+    // 反向地理编码（可能要请求地图API，只在换到新的示例位置时进行）
+    if (simulatedFixCount == 1 || simulatedFixCount % kFixesPerSampleLocation == 0) {
         currentLocation.address = reverseGeocode(currentLocation.latitude, currentLocation.longitude);
-        
-        // 更新位置名称
-        const std::string locationNames[5] = {
-            "故宫博物院",
-            "天坛公园",
-            "兵马俑博物馆",
-            "杭州西湖",
-            "深圳世界之窗"
-        };
-        currentLocation.locationName = locationNames[index];
-        
-        // 融合传感器数据（如果可用）
-        if (gpsAvailable || imuAvailable) {
-            fuseSensorData();
-        }
-        
-        // 保存为上一次位置
-        lastLocation = currentLocation;
-        
-        // 检查用户是否进入景区
-        checkScenicSpotEntry();
     }
+    
+    // 更新位置名称
+    const std::string locationNames[5] = {
+        "故宫博物院",
+        "天坛公园",
+        "兵马俑博物馆",
+        "杭州西湖",
+        "深圳世界之窗"
+    };
+    currentLocation.locationName = locationNames[index];
+    
+    // 融合传感器数据（如果可用）
+    if (gpsAvailable || imuAvailable) {
+        fuseSensorData();
+    }
+    
+    // 保存为上一次位置
+    lastLocation = currentLocation;
+    
+    // 检查用户是否进入景区
+    checkScenicSpotEntry();
+    
+    // 进入新景区时发布一次事件
+    if (eventBus && hasEnteredNewScenicSpot()) {
+        FenceEnteredEvent event;
+        event.scenicSpot = currentScenicSpot;
+        event.lastScenicSpot = lastScenicSpot;
+        event.latitude = currentLocation.latitude;
+        event.longitude = currentLocation.longitude;
+        eventBus->publish(event);
+    }
+}
+
+void LocationTracker::setEventBus(EventBus* bus) {
+    eventBus = bus;
 }
 
 // 检查用户是否进入景区
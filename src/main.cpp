@@ -1,10 +1,95 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cstdlib>
 #include "core/AICompanion.h"
+#include "core/CommandInput.h"
 #include "chat/Chatbot.h"
+#include "vision/VisionBenchmark.h"
 
-int main() {
+// 用法: AICompanion --bench <帧来源> [--realtime] [--backend 名称] [--no-gate]
+//                   [--interval 帧数] [--batch 帧数] [--cascade 筛选模型] [--seconds 秒数]
+static int runBenchmarkCommand(int argc, char** argv) {
+    VisionBenchmarkOptions options;
+    if (argc < 3) {
+        std::cerr << "用法: " << argv[0] << " --bench <视频文件|图像目录|路径.yuv:宽x高[:格式]|camera:N|synthetic>"
+                  << " [--realtime] [--backend 名称] [--no-gate] [--quality-gate] [--interval 帧数] [--batch 帧数]"
+                  << " [--cascade 筛选模型] [--budget 毫秒] [--seconds 秒数]" << std::endl;
+        return -1;
+    }
+    options.source = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--realtime") {
+            options.realTime = true;
+        } else if (arg == "--no-gate") {
+            options.sceneGate = false;
+        } else if (arg == "--quality-gate") {
+            options.qualityGate = true;
+        } else if (arg == "--backend" && hasValue) {
+            options.backend = argv[++i];
+        } else if (arg == "--interval" && hasValue) {
+            options.detectionInterval = std::atoi(argv[++i]);
+        } else if (arg == "--batch" && hasValue) {
+            options.batchSize = std::atoi(argv[++i]);
+        } else if (arg == "--cascade" && hasValue) {
+            options.cascadeModel = argv[++i];
+        } else if (arg == "--budget" && hasValue) {
+            options.latencyBudgetMs = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--seconds" && hasValue) {
+            options.maxSeconds = std::atof(argv[++i]);
+        } else {
+            std::cerr << "未知的基准测试参数: " << arg << std::endl;
+            return -1;
+        }
+    }
+    return runVisionBenchmark(options);
+}
+
+// 用法: AICompanion --nms-bench [--counts 1000,10000,25000] [--classes 类别数] [--repeats 次数] [--seed 种子]
+static int runNMSBenchmarkCommand(int argc, char** argv) {
+    NMSBenchmarkOptions options;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--counts" && hasValue) {
+            options.candidateCounts.clear();
+            std::string counts = argv[++i];
+            size_t begin = 0;
+            while (begin <= counts.size()) {
+                size_t end = counts.find(',', begin);
+                if (end == std::string::npos) {
+                    end = counts.size();
+                }
+                options.candidateCounts.push_back(std::atoi(counts.substr(begin, end - begin).c_str()));
+                begin = end + 1;
+            }
+        } else if (arg == "--classes" && hasValue) {
+            options.classCount = std::atoi(argv[++i]);
+        } else if (arg == "--repeats" && hasValue) {
+            options.repeats = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], NULL, 10));
+        } else {
+            std::cerr << "未知的NMS基准测试参数: " << arg << std::endl;
+            std::cerr << "用法: " << argv[0] << " --nms-bench [--counts 1000,10000,25000] [--classes 类别数]"
+                      << " [--repeats 次数] [--seed 种子]" << std::endl;
+            return -1;
+        }
+    }
+    return runNMSBenchmark(options);
+}
+
+int main(int argc, char** argv) {
+    // 离线视觉基准测试，不启动交互式系统
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return runBenchmarkCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--nms-bench") {
+        return runNMSBenchmarkCommand(argc, argv);
+    }
+    
     // 创建AI智能伴游实例
     AICompanion companion;
     
@@ -16,16 +101,21 @@ int main() {
     
     std::cout << "AI智能伴游系统启动成功！" << std::endl;
     
+    // 用户输入由独立的输入线程读取，各子系统由调度器在后台按各自的频率更新，
+    // 主循环只从命令队列中取出命令并分发
+    CommandInput input;
+    input.start();
+    
     // 主循环
     bool running = true;
+    std::string command;
     while (running) {
-        // 更新系统状态
-        companion.update();
-        
-        // 检查用户输入
-        std::string command;
-        std::cout << "请输入命令 (help for commands): ";
-        std::getline(std::cin, command);
+        std::cout << "请输入命令 (help for commands): " << std::flush;
+        if (!input.nextCommand(command)) {
+            // 输入结束（EOF）
+            std::cout << std::endl;
+            break;
+        }
         
         if (command == "exit" || command == "quit") {
             running = false;
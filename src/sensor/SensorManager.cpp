@@ -4,8 +4,11 @@
 #include <ctime>
 #include <sstream>
 #include <chrono>
+#include "core/EventBus.h"
 
 SensorManager::SensorManager() {
+    eventBus = nullptr;
+    
     // 初始化随机数生成器
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
 }
@@ -30,14 +33,29 @@ bool SensorManager::initialize() {
 
 void SensorManager::update() {
     // 更新所有激活的传感器数据
+    for (const auto& sensor : sensors) {
+        update(sensor.type);
+    }
+}
+
+void SensorManager::update(SensorType type) {
     for (auto& sensor : sensors) {
-        if (sensor.isActive && sensor.isAvailable) {
+        if (sensor.type == type && sensor.isActive && sensor.isAvailable) {
             // 读取传感器数据
             SensorData data = readSensorData(sensor.type);
             
             // 处理传感器数据
             processSensorData(data);
             
+            if (eventBus) {
+                SensorSampleEvent event;
+                event.type = data.type;
+                event.value = data.value;
+                event.isValid = data.isValid;
+                event.timestamp = std::chrono::steady_clock::now();
+                eventBus->publish(event);
+            }
+            
             // 添加到缓存
             sensorDataCache.push_back(data);
             
@@ -369,4 +387,8 @@ bool SensorManager::calibrateSensor(SensorType type) {
     // 在实际应用中，这里应该包含传感器的校准逻辑
     // 在这个简单实现中，我们只是返回true
     return true;
-}
\ No newline at end of file
+}
+
+void SensorManager::setEventBus(EventBus* bus) {
+    eventBus = bus;
+}
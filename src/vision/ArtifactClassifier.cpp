@@ -0,0 +1,249 @@
+#include "vision/ArtifactClassifier.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace {
+// ImageNet的RGB均值和标准差（常见分类模型导出时使用的归一化）
+const float kMean[3] = {0.485f, 0.456f, 0.406f};
+const float kStd[3] = {0.229f, 0.224f, 0.225f};
+
+// 检测框每边向外扩展的比例，给分类器留一圈上下文
+const float kContextMargin = 0.1f;
+} // namespace
+
+ArtifactClassifier::ArtifactClassifier()
+    : size(224), minScore(0.5f), batchSupported(true), modelInputCrops(0), frameCrops(0) {}
+
+bool ArtifactClassifier::load(const std::string& modelPath, const std::string& labelsPath,
+                              const std::string& backendName, int inputSize) {
+    unload();
+    if (inputSize < 32) {
+        std::cerr << "文物分类模型的输入尺寸无效: " << inputSize << std::endl;
+        return false;
+    }
+
+    std::ifstream labels(labelsPath);
+    if (!labels.is_open()) {
+        std::cerr << "无法加载文物类别文件: " << labelsPath << std::endl;
+        return false;
+    }
+    std::string name;
+    while (std::getline(labels, name)) {
+        if (!name.empty() && name[name.size() - 1] == '\r') {
+            name.erase(name.size() - 1);
+        }
+        if (!name.empty()) {
+            names.push_back(name);
+            background.push_back(name == "background" || name == "none");
+        }
+    }
+    if (names.empty()) {
+        std::cerr << "文物类别文件为空: " << labelsPath << std::endl;
+        return false;
+    }
+
+    backend = createInferenceBackend(backendName);
+    if (!backend || !backend->load(modelPath)) {
+        std::cerr << "无法加载文物分类模型: " << modelPath << std::endl;
+        unload();
+        return false;
+    }
+    if (backend->inputDepth() != CV_32F) {
+        std::cerr << "文物分类模型需要float输入" << std::endl;
+        unload();
+        return false;
+    }
+
+    // 裁剪张量按每帧的最大裁剪数一次分配，之后每帧只使用前N个
+    size = inputSize;
+    const int shape[] = {kMaxCrops, 3, size, size};
+    cropTensor.create(4, shape, CV_32F);
+    batchSupported = backend->supportsBatch();
+
+    // 试推理一个裁剪，确认输出的类别数与类别文件一致
+    const int singleShape[] = {1, 3, size, size};
+    cv::Mat probe(4, singleShape, CV_32F, cropTensor.data);
+    std::memset(probe.data, 0, probe.total() * probe.elemSize());
+    if (!backend->forward(probe, outputs) || outputs.empty() || outputs[0].total() != names.size()) {
+        std::cerr << "文物分类模型的输出与类别文件不一致（" << names.size() << " 个类别）" << std::endl;
+        unload();
+        return false;
+    }
+    std::cout << "文物分类模型已加载: " << modelPath << "（" << names.size() << " 个类别，输入 "
+              << size << "×" << size << "）" << std::endl;
+    return true;
+}
+
+void ArtifactClassifier::unload() {
+    backend.reset();
+    names.clear();
+    background.clear();
+    outputs.clear();
+}
+
+bool ArtifactClassifier::classify(const cv::Mat& frame, const cv::Mat* modelInput, const LetterboxInfo& letterbox,
+                                  const std::vector<cv::Rect>& boxes, std::vector<ArtifactPrediction>& predictions) {
+    predictions.assign(boxes.size(), ArtifactPrediction());
+    if (!backend) {
+        return false;
+    }
+    if (frame.empty() || boxes.empty()) {
+        return true;
+    }
+
+    const bool useModelInput = modelInput && modelInput->dims == 4 && modelInput->depth() == CV_32F &&
+                               modelInput->size[2] == letterbox.inputHeight &&
+                               modelInput->size[3] == letterbox.inputWidth && letterbox.scale > 0.0f;
+
+    // 第一步：各检测框裁剪写入裁剪张量
+    cropOwners.clear();
+    int count = 0;
+    for (size_t i = 0; i < boxes.size() && count < kMaxCrops; ++i) {
+        const cv::Rect& box = boxes[i];
+        const cv::Rect2f region = expandBox(box, kContextMargin, frame.size());
+        if (region.width < 1.0f || region.height < 1.0f) {
+            continue;
+        }
+
+        // 目标在模型输入中至少有分类器输入的一半大时，直接从已缩放的模型输入中裁剪
+        if (useModelInput && std::max(region.width, region.height) * letterbox.scale * 2.0f >= size) {
+            cropFromModelInput(*modelInput,
+                               cv::Rect2f(region.x * letterbox.scale + letterbox.padX,
+                                          region.y * letterbox.scale + letterbox.padY,
+                                          region.width * letterbox.scale, region.height * letterbox.scale),
+                               count);
+            ++modelInputCrops;
+        } else {
+            const int left = static_cast<int>(region.x);
+            const int top = static_cast<int>(region.y);
+            const int right = std::min(frame.cols, static_cast<int>(std::ceil(region.x + region.width)));
+            const int bottom = std::min(frame.rows, static_cast<int>(std::ceil(region.y + region.height)));
+            cropFromFrame(frame, cv::Rect(left, top, right - left, bottom - top), count);
+            ++frameCrops;
+        }
+        cropOwners.push_back(static_cast<int>(i));
+        ++count;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    // 第二步：所有裁剪一次批量前向推理；模型不支持动态批次时逐个推理
+    const size_t classCount = names.size();
+    if (batchSupported && count > 1) {
+        const int shape[] = {count, 3, size, size};
+        cv::Mat batch(4, shape, CV_32F, cropTensor.data);
+        if (backend->forward(batch, outputs) && !outputs.empty() && outputs[0].size[0] == count &&
+            outputs[0].total() == static_cast<size_t>(count) * classCount) {
+            for (int j = 0; j < count; ++j) {
+                predictions[static_cast<size_t>(cropOwners[static_cast<size_t>(j)])] = decode(outputs[0], j);
+            }
+            return true;
+        }
+        std::cerr << "文物分类模型不支持批量推理，改为逐个裁剪推理" << std::endl;
+        batchSupported = false;
+    }
+
+    const int singleShape[] = {1, 3, size, size};
+    const size_t cropFloats = static_cast<size_t>(3) * size * size;
+    for (int j = 0; j < count; ++j) {
+        cv::Mat single(4, singleShape, CV_32F, cropTensor.ptr<float>() + cropFloats * j);
+        if (!backend->forward(single, outputs) || outputs.empty() || outputs[0].total() != classCount) {
+            predictions.assign(boxes.size(), ArtifactPrediction());
+            return false;
+        }
+        predictions[static_cast<size_t>(cropOwners[static_cast<size_t>(j)])] = decode(outputs[0], 0);
+    }
+    return true;
+}
+
+void ArtifactClassifier::cropFromModelInput(const cv::Mat& modelInput, const cv::Rect2f& region, int index) {
+    // 在已缩放的CHW张量上双线性采样，值已是RGB、[0,1]，只需再做均值/方差归一化
+    const int width = modelInput.size[3];
+    const int height = modelInput.size[2];
+    const size_t plane = static_cast<size_t>(width) * height;
+    const size_t cropPlane = static_cast<size_t>(size) * size;
+    const float* src = modelInput.ptr<float>();
+    float* dst = cropTensor.ptr<float>() + cropPlane * 3 * index;
+
+    const float stepX = region.width / size;
+    const float stepY = region.height / size;
+    x0.resize(static_cast<size_t>(size));
+    xWeight.resize(static_cast<size_t>(size));
+    for (int x = 0; x < size; ++x) {
+        float fx = std::min(std::max(region.x + (x + 0.5f) * stepX - 0.5f, 0.0f), width - 1.0f);
+        int ix = std::min(static_cast<int>(fx), width - 2);
+        x0[static_cast<size_t>(x)] = ix;
+        xWeight[static_cast<size_t>(x)] = fx - ix;
+    }
+
+    for (int y = 0; y < size; ++y) {
+        float fy = std::min(std::max(region.y + (y + 0.5f) * stepY - 0.5f, 0.0f), height - 1.0f);
+        int iy = std::min(static_cast<int>(fy), height - 2);
+        const float wy = fy - iy;
+        for (int c = 0; c < 3; ++c) {
+            const float* row0 = src + plane * c + static_cast<size_t>(iy) * width;
+            const float* row1 = row0 + width;
+            float* out = dst + cropPlane * c + static_cast<size_t>(y) * size;
+            const float mean = kMean[c];
+            const float invStd = 1.0f / kStd[c];
+            for (int x = 0; x < size; ++x) {
+                const int ix = x0[static_cast<size_t>(x)];
+                const float wx = xWeight[static_cast<size_t>(x)];
+                const float top = row0[ix] + (row0[ix + 1] - row0[ix]) * wx;
+                const float bottom = row1[ix] + (row1[ix + 1] - row1[ix]) * wx;
+                out[x] = (top + (bottom - top) * wy - mean) * invStd;
+            }
+        }
+    }
+}
+
+void ArtifactClassifier::cropFromFrame(const cv::Mat& frame, const cv::Rect& region, int index) {
+    // 只缩放检测框所在的区域，缩放缓冲区在裁剪之间复用
+    cv::resize(frame(region), resized, cv::Size(size, size), 0, 0, cv::INTER_LINEAR);
+
+    const size_t cropPlane = static_cast<size_t>(size) * size;
+    float* dst = cropTensor.ptr<float>() + cropPlane * 3 * index;
+    for (int y = 0; y < size; ++y) {
+        const uchar* pixel = resized.ptr<uchar>(y);
+        const size_t offset = static_cast<size_t>(y) * size;
+        for (int x = 0; x < size; ++x, pixel += 3) {
+            // BGR → RGB
+            dst[offset + x] = (pixel[2] / 255.0f - kMean[0]) / kStd[0];
+            dst[cropPlane + offset + x] = (pixel[1] / 255.0f - kMean[1]) / kStd[1];
+            dst[cropPlane * 2 + offset + x] = (pixel[0] / 255.0f - kMean[2]) / kStd[2];
+        }
+    }
+}
+
+ArtifactPrediction ArtifactClassifier::decode(const cv::Mat& output, int row) {
+    const size_t classCount = names.size();
+    probabilities.resize(classCount);
+    if (output.depth() == CV_32F) {
+        const float* values = output.ptr<float>() + classCount * row;
+        std::copy(values, values + classCount, probabilities.begin());
+    } else {
+        const QuantizationParams quantization = backend->outputQuantization(0);
+        for (size_t i = 0; i < classCount; ++i) {
+            const size_t at = classCount * row + i;
+            probabilities[i] = quantization.dequantize(output.depth() == CV_8S
+                ? static_cast<int>(reinterpret_cast<const int8_t*>(output.data)[at])
+                : static_cast<int>(output.data[at]));
+        }
+    }
+
+    toProbabilities(probabilities.data(), classCount);
+
+    ArtifactPrediction prediction;
+    const size_t best = static_cast<size_t>(std::max_element(probabilities.begin(), probabilities.end()) -
+                                            probabilities.begin());
+    if (!background[best] && probabilities[best] >= minScore) {
+        prediction.classId = static_cast<int>(best);
+        prediction.score = probabilities[best];
+    }
+    return prediction;
+}
@@ -0,0 +1,100 @@
+#include "vision/Detection.h"
+
+int LabelTable::intern(const std::string& label) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, int>::const_iterator it = ids.find(label);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    const int id = static_cast<int>(names.size());
+    names.push_back(label);
+    ids.insert(std::make_pair(label, id));
+    return id;
+}
+
+int LabelTable::find(const std::string& label) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, int>::const_iterator it = ids.find(label);
+    return it != ids.end() ? it->second : -1;
+}
+
+const std::string& LabelTable::name(int labelId) const {
+    static const std::string unknown;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (labelId < 0 || static_cast<size_t>(labelId) >= names.size()) {
+        return unknown;
+    }
+    return names[static_cast<size_t>(labelId)];
+}
+
+DetectionView::DetectionView(const std::shared_ptr<DetectionBuffer>& buffer) : buffer(buffer) {
+    if (buffer) {
+        buffer->readers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+DetectionView::DetectionView(const DetectionView& other) : buffer(other.buffer) {
+    if (buffer) {
+        buffer->readers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+DetectionView& DetectionView::operator=(const DetectionView& other) {
+    DetectionView copy(other);
+    buffer.swap(copy.buffer);
+    return *this;
+}
+
+DetectionView::~DetectionView() {
+    if (buffer) {
+        // 与写入方检查readers时的acquire配对：读取完成之后缓冲区才会被覆盖
+        buffer->readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+const std::vector<Detection>& DetectionView::detections() const {
+    static const std::vector<Detection> none;
+    return buffer ? buffer->frame.detections : none;
+}
+
+DetectionResultSlot::DetectionResultSlot() : writing(0), sequence(0) {
+    for (int i = 0; i < 3; ++i) {
+        buffers.push_back(std::make_shared<DetectionBuffer>());
+    }
+}
+
+DetectionFrame& DetectionResultSlot::beginWrite() {
+    std::lock_guard<std::mutex> lock(mutex);
+    // 已发布的缓冲区和读取方持有的缓冲区都不能写入。读取方只能在锁内从latest取得新的视图，
+    // 或者复制一个已有的视图，所以这里看到readers为0的非latest缓冲区之后，不会再有新的读取方
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        if (buffers[i] != latest && buffers[i]->readers.load(std::memory_order_acquire) == 0) {
+            writing = i;
+            return buffers[i]->frame;
+        }
+    }
+    buffers.push_back(std::make_shared<DetectionBuffer>());
+    writing = buffers.size() - 1;
+    return buffers[writing]->frame;
+}
+
+void DetectionResultSlot::publish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers[writing]->frame.sequence = ++sequence;
+    latest = buffers[writing];
+}
+
+DetectionView DetectionResultSlot::read() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return DetectionView(latest);
+}
+
+void DetectionResultSlot::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    latest.reset();
+}
+
+size_t DetectionResultSlot::bufferCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffers.size();
+}
@@ -0,0 +1,121 @@
+#include "vision/FrameBufferPool.h"
+
+FrameBufferPool::FrameBufferPool() : allocations(0) {
+}
+
+FrameBufferPool::~FrameBufferPool() {
+    clear();
+}
+
+void FrameBufferPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto* slot : slots) {
+        delete slot;
+    }
+    for (auto* set : batchSets) {
+        delete set;
+    }
+    slots.clear();
+    freeSlots.clear();
+    batchSets.clear();
+}
+
+void FrameBufferPool::configure(size_t slotCount, const cv::Size& frameSize, const cv::Size& inputSize) {
+    clear();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.reserve(slotCount);
+    freeSlots.reserve(slotCount);
+    batchSets.reserve(slotCount);
+    
+    const int blobShape[] = {1, 3, inputSize.height, inputSize.width};
+    for (size_t i = 0; i < slotCount; ++i) {
+        FrameSlot* slot = new FrameSlot();
+        slot->frame.create(frameSize, CV_8UC3);
+        slot->blob.create(4, blobShape, CV_32F);
+        slots.push_back(slot);
+        freeSlots.push_back(slot);
+        allocations += 2;
+    }
+}
+
+FrameSlot* FrameBufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeSlots.empty()) {
+        return nullptr;
+    }
+    FrameSlot* slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+}
+
+void FrameBufferPool::release(FrameSlot* slot) {
+    if (!slot) {
+        return;
+    }
+    
+    if (slot->batchOutputs) {
+        --slot->batchOutputs->refs;
+        slot->batchOutputs = nullptr;
+    }
+    slot->batchIndex = 0;
+    slot->inferenceOk = false;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    freeSlots.push_back(slot);
+}
+
+BatchOutputSet* FrameBufferPool::acquireBatchOutputs(int users) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto* set : batchSets) {
+        if (set->refs == 0) {
+            set->refs = users;
+            return set;
+        }
+    }
+    
+    // 所有批量输出都在被解码，只有在这种情况下才新建一组
+    BatchOutputSet* set = new BatchOutputSet();
+    set->refs = users;
+    batchSets.push_back(set);
+    ++allocations;
+    return set;
+}
+
+void FrameBufferPool::ensureMat(cv::Mat& mat, int rows, int cols, int type) {
+    if (mat.dims == 2 && mat.rows == rows && mat.cols == cols && mat.type() == type) {
+        return;
+    }
+    mat.create(rows, cols, type);
+    ++allocations;
+}
+
+void FrameBufferPool::ensureMat(cv::Mat& mat, int dims, const int* shape, int type) {
+    bool same = !mat.empty() && mat.dims == dims && mat.type() == type;
+    for (int i = 0; same && i < dims; ++i) {
+        same = mat.size[i] == shape[i];
+    }
+    if (same) {
+        return;
+    }
+    mat.create(dims, shape, type);
+    ++allocations;
+}
+
+void FrameBufferPool::noteAllocation() {
+    ++allocations;
+}
+
+size_t FrameBufferPool::allocationCount() const {
+    return allocations;
+}
+
+size_t FrameBufferPool::freeCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return freeSlots.size();
+}
+
+size_t FrameBufferPool::slotCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots.size();
+}
@@ -0,0 +1,162 @@
+#include "vision/FrameQualityGate.h"
+#include "utils/simd.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+#if defined(AICOMPANION_HAVE_AVX2) || defined(AICOMPANION_HAVE_SSE2)
+// 把向量中的int32元素相加
+template <typename Vector>
+int64_t sumLanes(const Vector& v) {
+    int32_t lanes[sizeof(Vector) / sizeof(int32_t)];
+    std::memcpy(lanes, &v, sizeof(Vector));
+    int64_t total = 0;
+    for (int32_t lane : lanes) {
+        total += lane;
+    }
+    return total;
+}
+#endif
+} // namespace
+
+void computeSharpnessAndLuma(const uint8_t* gray, int width, int height, float& sharpness, float& luma) {
+    sharpness = 0.0f;
+    luma = 0.0f;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // 平均亮度
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    uint64_t lumaSum = 0;
+    size_t i = 0;
+#if defined(AICOMPANION_HAVE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= pixelCount; i += 16) {
+        // 与0的绝对差之和即16个像素之和，分两个64位部分给出
+        __m128i sad = _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gray + i)), zero);
+        lumaSum += static_cast<uint64_t>(_mm_cvtsi128_si32(sad)) +
+                   static_cast<uint64_t>(_mm_cvtsi128_si32(_mm_srli_si128(sad, 8)));
+    }
+#endif
+    for (; i < pixelCount; ++i) {
+        lumaSum += gray[i];
+    }
+    luma = static_cast<float>(lumaSum) / pixelCount;
+
+    if (width < 3 || height < 3) {
+        return;
+    }
+
+    // 4邻域拉普拉斯：上 + 下 + 左 + 右 - 4 × 中心，取值在[-1020, 1020]，int16足够；
+    // 每行先在32位累加器中求和与平方和，再并入64位总和
+    int64_t sum = 0;
+    int64_t sumSq = 0;
+    for (int y = 1; y < height - 1; ++y) {
+        const uint8_t* up = gray + static_cast<size_t>(y - 1) * width;
+        const uint8_t* mid = up + width;
+        const uint8_t* down = mid + width;
+        int x = 1;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i rowSum = _mm256_setzero_si256();
+        __m256i rowSq = _mm256_setzero_si256();
+        for (; x + 16 <= width - 1; x += 16) {
+            __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + x)));
+            __m256i l = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + x - 1)));
+            __m256i r = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + x + 1)));
+            __m256i u = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x)));
+            __m256i d = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x)));
+            __m256i lap = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(l, r), _mm256_add_epi16(u, d)),
+                                           _mm256_slli_epi16(c, 2));
+            rowSum = _mm256_add_epi32(rowSum, _mm256_madd_epi16(lap, ones));
+            rowSq = _mm256_add_epi32(rowSq, _mm256_madd_epi16(lap, lap));
+        }
+        sum += sumLanes(rowSum);
+        sumSq += sumLanes(rowSq);
+#elif defined(AICOMPANION_HAVE_SSE2)
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i rowSum = _mm_setzero_si128();
+        __m128i rowSq = _mm_setzero_si128();
+        for (; x + 8 <= width - 1; x += 8) {
+            __m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mid + x)), zero);
+            __m128i l = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mid + x - 1)), zero);
+            __m128i r = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mid + x + 1)), zero);
+            __m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(up + x)), zero);
+            __m128i d = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(down + x)), zero);
+            __m128i lap = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(l, r), _mm_add_epi16(u, d)),
+                                        _mm_slli_epi16(c, 2));
+            rowSum = _mm_add_epi32(rowSum, _mm_madd_epi16(lap, ones));
+            rowSq = _mm_add_epi32(rowSq, _mm_madd_epi16(lap, lap));
+        }
+        sum += sumLanes(rowSum);
+        sumSq += sumLanes(rowSq);
+#endif
+
+        for (; x < width - 1; ++x) {
+            const int lap = up[x] + down[x] + mid[x - 1] + mid[x + 1] - 4 * mid[x];
+            sum += lap;
+            sumSq += lap * lap;
+        }
+    }
+
+    const double count = static_cast<double>(width - 2) * (height - 2);
+    const double mean = sum / count;
+    sharpness = static_cast<float>(std::max(0.0, sumSq / count - mean * mean));
+}
+
+FrameQualityGate::FrameQualityGate(const FrameQualityGateConfig& config)
+    : config(config), started(false) {}
+
+void FrameQualityGate::setConfig(const FrameQualityGateConfig& newConfig) {
+    config = newConfig;
+    started = false;
+}
+
+void FrameQualityGate::computeGray(const cv::Mat& frame) {
+    // 区域平均缩小：去掉传感器噪声对拉普拉斯的影响，模糊造成的边缘损失仍然保留
+    const int width = std::min(config.thumbWidth, frame.cols);
+    const int height = std::max(1, frame.rows * width / frame.cols);
+    cv::resize(frame, thumb, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+
+    gray.resize(static_cast<size_t>(width) * height);
+    const int channels = thumb.channels();
+    for (int y = 0; y < height; ++y) {
+        const uchar* src = thumb.ptr<uchar>(y);
+        uint8_t* dst = gray.data() + static_cast<size_t>(y) * width;
+        if (channels == 1) {
+            std::copy(src, src + width, dst);
+        } else {
+            // BGR → 灰度（整数近似 0.114B + 0.587G + 0.299R）
+            for (int x = 0; x < width; ++x) {
+                const uchar* p = src + x * channels;
+                dst[x] = static_cast<uint8_t>((29 * p[0] + 150 * p[1] + 77 * p[2]) >> 8);
+            }
+        }
+    }
+}
+
+FrameQualityScores FrameQualityGate::evaluate(const cv::Mat& frame, std::chrono::steady_clock::time_point now) {
+    scores = FrameQualityScores();
+    if (frame.empty()) {
+        scores.admitted = false;
+        return scores;
+    }
+
+    computeGray(frame);
+    computeSharpnessAndLuma(gray.data(), thumb.cols, thumb.rows, scores.sharpness, scores.luma);
+
+    if (!started) {
+        started = true;
+        lastAdmitted = now;
+    }
+    const bool good = scores.sharpness >= config.minSharpness &&
+                      scores.luma >= config.minLuma && scores.luma <= config.maxLuma;
+    // 连续拒绝太久时放行一帧：画面一直偏暗或一直在晃动时仍然保持最低的检测频率
+    scores.admitted = good || now - lastAdmitted >= std::chrono::milliseconds(config.maxRejectMs);
+    if (scores.admitted) {
+        lastAdmitted = now;
+    }
+    return scores;
+}
@@ -0,0 +1,257 @@
+#include "vision/FrameRecorder.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include "utils/FileSystem.h"
+
+namespace {
+// 编码队列容量，积压超过时丢弃最旧的任务
+const size_t kMaxPendingTasks = 64;
+
+// 环形缓冲区在事件前帧数之外多保留的帧数：检测结果比采集晚几帧，
+// 触发事件时事件帧之后采集的帧也还在缓冲区中
+const size_t kPipelineLatencyFrames = 8;
+
+std::string clipFramePath(const std::string& directory, int index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/frame_%03d.jpg", index);
+    return directory + name;
+}
+} // namespace
+
+FrameRecorder::FrameRecorder()
+    : nextSlot(0), frameCount(0), postEventFrames(0), retainFrames(false), framesWanted(false),
+      tasks(kMaxPendingTasks), encoderStarted(false), jpegQuality(90), written(0) {
+    configure(15, 15);
+}
+
+FrameRecorder::~FrameRecorder() {
+    // 关闭后编码线程把队列中剩余的任务写完再退出
+    tasks.close();
+    if (encoder.joinable()) {
+        encoder.join();
+    }
+}
+
+void FrameRecorder::configure(size_t preEventFrames, size_t postFrames) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ring.assign(preEventFrames + kPipelineLatencyFrames, RingEntry());
+    nextSlot = 0;
+    frameCount = 0;
+    postEventFrames = postFrames;
+    pendingClips.clear();
+    pendingSnapshots.clear();
+    updateFramesWanted();
+}
+
+void FrameRecorder::setRetainFrames(bool retain) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (retain != retainFrames) {
+        retainFrames = retain;
+        nextSlot = 0;
+        frameCount = 0;
+    }
+    updateFramesWanted();
+}
+
+void FrameRecorder::setJpegQuality(int quality) {
+    if (quality >= 1 && quality <= 100) {
+        jpegQuality = quality;
+    }
+}
+
+void FrameRecorder::pushFrame(const cv::Mat& frame, unsigned long frameId,
+                              std::chrono::steady_clock::time_point timestamp) {
+    // 没有人需要这一帧时不加锁、不复制
+    if (!framesWanted.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!retainFrames && pendingSnapshots.empty() && pendingClips.empty()) {
+        return;
+    }
+    RingEntry& entry = ring[nextSlot];
+    if (entry.shared) {
+        // 旧缓冲区还在编码线程手中，换一块新的
+        entry.image = cv::Mat();
+        entry.shared = false;
+    }
+    frame.copyTo(entry.image);
+    entry.frameId = frameId;
+    entry.timestamp = timestamp;
+    nextSlot = (nextSlot + 1) % ring.size();
+    if (frameCount < ring.size()) {
+        ++frameCount;
+    }
+
+    // 等待下一帧的快照
+    for (const auto& path : pendingSnapshots) {
+        submitEntry(entry, path, std::string());
+    }
+    pendingSnapshots.clear();
+
+    // 等待事件后帧的片段
+    for (size_t i = 0; i < pendingClips.size();) {
+        PendingClip& clip = pendingClips[i];
+        submitEntry(entry, clipFramePath(clip.directory, clip.nextIndex++), clip.directory);
+        if (--clip.remaining == 0) {
+            pendingClips.erase(pendingClips.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            ++i;
+        }
+    }
+
+    // 不保留时这一帧只用于等待中的请求，之后的请求等新的帧
+    if (!retainFrames) {
+        frameCount = 0;
+    }
+    updateFramesWanted();
+}
+
+bool FrameRecorder::requestSnapshot(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!retainFrames) {
+        pendingSnapshots.push_back(path);
+        updateFramesWanted();
+        return true;
+    }
+    if (frameCount == 0) {
+        return false;
+    }
+    RingEntry& latest = ring[(nextSlot + ring.size() - 1) % ring.size()];
+    submitEntry(latest, path, std::string());
+    return true;
+}
+
+bool FrameRecorder::requestClip(const std::string& directory, unsigned long eventFrameId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!retainFrames) {
+        // 没有保留最近帧：以下一帧为事件帧
+        PendingClip clip;
+        clip.directory = directory;
+        clip.remaining = postEventFrames + 1;
+        clip.nextIndex = 0;
+        pendingClips.push_back(clip);
+        updateFramesWanted();
+        return true;
+    }
+    if (frameCount == 0) {
+        return false;
+    }
+
+    if (eventFrameId == 0) {
+        eventFrameId = ring[(nextSlot + ring.size() - 1) % ring.size()].frameId;
+    }
+
+    // 从旧到新遍历缓冲区：事件帧及之前的帧只保留最新的preEventFrames帧，
+    // 之后的帧计入事件后帧数，不够的部分等后续采集
+    const size_t preEventFrames = ring.size() - kPipelineLatencyFrames;
+    const size_t oldest = (nextSlot + ring.size() - frameCount) % ring.size();
+    size_t eventFramesInRing = 0;
+    for (size_t i = 0; i < frameCount; ++i) {
+        if (ring[(oldest + i) % ring.size()].frameId <= eventFrameId) {
+            ++eventFramesInRing;
+        }
+    }
+    const size_t skip = eventFramesInRing > preEventFrames ? eventFramesInRing - preEventFrames : 0;
+
+    PendingClip clip;
+    clip.directory = directory;
+    clip.remaining = postEventFrames;
+    clip.nextIndex = 0;
+    size_t seenBefore = 0;
+    for (size_t i = 0; i < frameCount; ++i) {
+        RingEntry& entry = ring[(oldest + i) % ring.size()];
+        if (entry.frameId <= eventFrameId) {
+            if (seenBefore++ < skip) {
+                continue;
+            }
+        } else if (clip.remaining > 0) {
+            --clip.remaining;
+        } else {
+            break;
+        }
+        submitEntry(entry, clipFramePath(directory, clip.nextIndex++), directory);
+    }
+
+    if (clip.remaining > 0) {
+        pendingClips.push_back(clip);
+        updateFramesWanted();
+    }
+    return true;
+}
+
+void FrameRecorder::cancelPendingClips() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingClips.clear();
+    updateFramesWanted();
+}
+
+size_t FrameRecorder::writtenCount() const {
+    return written;
+}
+
+size_t FrameRecorder::droppedCount() const {
+    return tasks.droppedCount();
+}
+
+void FrameRecorder::submitEntry(RingEntry& entry, const std::string& path, const std::string& directory) {
+    EncodeTask task;
+    task.image = entry.image;   // 只增加引用，不复制像素
+    task.path = path;
+    task.directory = directory;
+    entry.shared = true;
+    enqueue(task);
+}
+
+void FrameRecorder::enqueue(const EncodeTask& task) {
+    if (!encoderStarted) {
+        encoderStarted = true;
+        encoder = std::thread(&FrameRecorder::encodeLoop, this);
+    }
+    if (tasks.push(task)) {
+        std::cerr << "图像编码任务积压，已丢弃最旧的任务" << std::endl;
+    }
+}
+
+void FrameRecorder::updateFramesWanted() {
+    framesWanted = retainFrames || !pendingSnapshots.empty() || !pendingClips.empty();
+}
+
+void FrameRecorder::encodeLoop() {
+    EncodeTask task;
+    std::vector<uchar> encoded;   // 编码缓冲区在图像之间复用
+    std::vector<int> params(2);
+    std::string createdDirectory;
+
+    while (tasks.pop(task)) {
+        if (!task.directory.empty() && task.directory != createdDirectory) {
+            if (!ensureDirectory(task.directory)) {
+                std::cerr << "创建目录失败: " << task.directory << std::endl;
+            }
+            createdDirectory = task.directory;
+        }
+
+        params[0] = cv::IMWRITE_JPEG_QUALITY;
+        params[1] = jpegQuality;
+        bool ok = false;
+        try {
+            ok = cv::imencode(".jpg", task.image, encoded, params);
+        } catch (const cv::Exception& e) {
+            std::cerr << "JPEG编码失败: " << e.what() << std::endl;
+        }
+        if (ok) {
+            std::ofstream out(task.path.c_str(), std::ios::binary);
+            out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+            ok = out.good();
+        }
+        if (ok) {
+            ++written;
+        } else {
+            std::cerr << "保存图像失败: " << task.path << std::endl;
+        }
+
+        // 尽早释放对帧缓冲区的引用
+        task.image.release();
+    }
+}
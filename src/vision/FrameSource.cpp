@@ -0,0 +1,226 @@
+#include "vision/FrameSource.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/stat.h>
+
+namespace {
+
+bool isDirectory(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFDIR) != 0;
+}
+
+/**
+ * @brief 模拟摄像头：在复用的缓冲区中生成空白图像
+ */
+class SyntheticFrameSource : public FrameSource {
+public:
+    bool open() override { return true; }
+
+    bool read(cv::Mat& frame) override {
+        frame.create(480, 640, CV_8UC3);
+        frame.setTo(cv::Scalar(0, 0, 0));
+        return true;
+    }
+
+    std::string description() const override { return "模拟摄像头"; }
+};
+
+/**
+ * @brief 视频文件或本地摄像头（cv::VideoCapture）
+ */
+class VideoFrameSource : public FrameSource {
+public:
+    explicit VideoFrameSource(const std::string& path) : path(path), cameraIndex(-1), ended(false) {}
+    explicit VideoFrameSource(int cameraIndex) : cameraIndex(cameraIndex), ended(false) {}
+
+    bool open() override {
+        ended = false;
+        if (cameraIndex >= 0) {
+            capture.open(cameraIndex);
+        } else {
+            capture.open(path);
+        }
+        return capture.isOpened();
+    }
+
+    bool read(cv::Mat& frame) override {
+        // VideoCapture::read在尺寸不变时复用frame的缓冲区
+        if (!capture.read(frame) || frame.empty()) {
+            ended = cameraIndex < 0;
+            return false;
+        }
+        return true;
+    }
+
+    std::string description() const override {
+        return cameraIndex >= 0 ? "摄像头 " + std::to_string(cameraIndex) : "视频文件 " + path;
+    }
+
+    double frameRate() const override {
+        return cameraIndex >= 0 ? 0.0 : capture.get(cv::CAP_PROP_FPS);
+    }
+
+    bool isLive() const override { return cameraIndex >= 0; }
+
+    bool finished() const override { return ended; }
+
+private:
+    std::string path;
+    int cameraIndex;
+    cv::VideoCapture capture;
+    bool ended;
+};
+
+/**
+ * @brief 按文件名顺序回放目录中的图像
+ */
+class ImageDirectoryFrameSource : public FrameSource {
+public:
+    explicit ImageDirectoryFrameSource(const std::string& directory) : directory(directory), next(0) {}
+
+    bool open() override {
+        files.clear();
+        next = 0;
+        std::vector<cv::String> matched;
+        const char* patterns[] = {"/*.jpg", "/*.jpeg", "/*.png", "/*.bmp"};
+        for (const char* pattern : patterns) {
+            try {
+                cv::glob(directory + pattern, matched, false);
+            } catch (const cv::Exception&) {
+                matched.clear();
+            }
+            files.insert(files.end(), matched.begin(), matched.end());
+        }
+        std::sort(files.begin(), files.end());
+        return !files.empty();
+    }
+
+    bool read(cv::Mat& frame) override {
+        while (next < files.size()) {
+            const std::string& file = files[next++];
+            image = cv::imread(file, cv::IMREAD_COLOR);
+            if (!image.empty()) {
+                image.copyTo(frame);
+                return true;
+            }
+            std::cerr << "无法读取图像: " << file << std::endl;
+        }
+        return false;
+    }
+
+    std::string description() const override {
+        return "图像目录 " + directory + "（" + std::to_string(files.size()) + " 张）";
+    }
+
+    bool finished() const override { return next >= files.size(); }
+
+private:
+    std::string directory;
+    std::vector<std::string> files;
+    size_t next;
+    cv::Mat image;
+};
+
+/**
+ * @brief 原始YUV文件（逐帧连续存放，无文件头）
+ */
+class RawYUVFrameSource : public FrameSource {
+public:
+    RawYUVFrameSource(const std::string& path, int width, int height, const std::string& format)
+        : path(path), width(width), height(height), format(format), ended(false) {}
+
+    bool open() override {
+        ended = false;
+        file.close();
+        file.clear();
+        file.open(path.c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        if (format == "yuyv") {
+            raw.create(height, width, CV_8UC2);
+            conversion = cv::COLOR_YUV2BGR_YUYV;
+        } else {
+            // 4:2:0格式：Y平面之后是色度平面，总共 高×1.5 行
+            raw.create(height * 3 / 2, width, CV_8UC1);
+            conversion = format == "nv12" ? cv::COLOR_YUV2BGR_NV12
+                       : format == "nv21" ? cv::COLOR_YUV2BGR_NV21
+                       : cv::COLOR_YUV2BGR_I420;
+        }
+        return true;
+    }
+
+    bool read(cv::Mat& frame) override {
+        const std::streamsize frameBytes = static_cast<std::streamsize>(raw.total() * raw.elemSize());
+        if (!file.read(reinterpret_cast<char*>(raw.data), frameBytes)) {
+            ended = true;
+            return false;
+        }
+        cv::cvtColor(raw, frame, conversion);
+        return true;
+    }
+
+    std::string description() const override {
+        return "YUV文件 " + path + "（" + std::to_string(width) + "x" + std::to_string(height) + " " + format + "）";
+    }
+
+    bool finished() const override { return ended; }
+
+private:
+    std::string path;
+    int width;
+    int height;
+    std::string format;
+    std::ifstream file;
+    cv::Mat raw;
+    int conversion;
+    bool ended;
+};
+
+} // namespace
+
+std::unique_ptr<FrameSource> createFrameSource(const std::string& spec) {
+    std::unique_ptr<FrameSource> source;
+    if (spec.empty() || spec == "synthetic") {
+        source.reset(new SyntheticFrameSource());
+        return source;
+    }
+    if (spec.compare(0, 7, "camera:") == 0) {
+        source.reset(new VideoFrameSource(std::atoi(spec.c_str() + 7)));
+        return source;
+    }
+    if (isDirectory(spec)) {
+        source.reset(new ImageDirectoryFrameSource(spec));
+        return source;
+    }
+
+    // 路径.yuv:宽x高[:格式]
+    const size_t yuv = spec.find(".yuv:");
+    if (yuv != std::string::npos) {
+        const std::string path = spec.substr(0, yuv + 4);
+        std::string size = spec.substr(yuv + 5);
+        std::string format = "i420";
+        const size_t colon = size.find(':');
+        if (colon != std::string::npos) {
+            format = size.substr(colon + 1);
+            size = size.substr(0, colon);
+        }
+        const size_t x = size.find('x');
+        const int width = x != std::string::npos ? std::atoi(size.c_str()) : 0;
+        const int height = x != std::string::npos ? std::atoi(size.c_str() + x + 1) : 0;
+        const bool knownFormat = format == "i420" || format == "nv12" || format == "nv21" || format == "yuyv";
+        // 4:2:0格式要求宽高都是偶数
+        if (width <= 0 || height <= 0 || width % 2 != 0 || height % 2 != 0 || !knownFormat) {
+            std::cerr << "无效的YUV来源描述: " << spec << "（格式: 路径.yuv:宽x高[:i420|nv12|nv21|yuyv]）" << std::endl;
+            return source;
+        }
+        source.reset(new RawYUVFrameSource(path, width, height, format));
+        return source;
+    }
+
+    source.reset(new VideoFrameSource(spec));
+    return source;
+}
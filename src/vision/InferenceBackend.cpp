@@ -0,0 +1,666 @@
+#include "vision/InferenceBackend.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include "vision/yolo_decoder.h"
+
+#ifdef HAVE_ONNXRUNTIME
+#include <onnxruntime_cxx_api.h>
+#endif
+
+#ifdef HAVE_TFLITE
+#include <tensorflow/lite/interpreter.h>
+#include <tensorflow/lite/kernels/register.h>
+#include <tensorflow/lite/model.h>
+#include <tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h>
+#endif
+
+// OpenCV 4.9起CPU目标支持FP16推理
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 9)
+#define AICOMPANION_HAVE_DNN_CPU_FP16 1
+#endif
+
+namespace {
+
+int workerThreadCount() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? static_cast<int>(cores) : 1;
+}
+
+bool fileExists(const std::string& path) {
+    return std::ifstream(path.c_str()).good();
+}
+
+/**
+ * @brief OpenCV DNN后端（FP32或FP16）
+ */
+class OpenCVDnnBackend : public InferenceBackend {
+public:
+    explicit OpenCVDnnBackend(bool fp16) : fp16(fp16) {}
+
+    std::string name() const override { return fp16 ? "opencv-fp16" : "opencv-cpu"; }
+
+    bool load(const std::string& modelPath) override {
+        try {
+            net = cv::dnn::readNetFromONNX(modelPath);
+            if (net.empty()) {
+                return false;
+            }
+#ifdef AICOMPANION_HAVE_DNN_CPU_FP16
+            if (fp16) {
+                net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+                net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU_FP16);
+            } else
+#endif
+            {
+                net.setPreferableBackend(cv::dnn::DNN_BACKEND_DEFAULT);
+                net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+            }
+            outputNames = net.getUnconnectedOutLayersNames();
+        } catch (const cv::Exception& e) {
+            std::cerr << name() << " 加载模型失败: " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        try {
+            net.setInput(blob);
+            // 输出写入调用方复用的张量，形状不变时不会重新分配
+            net.forward(outputs, outputNames);
+        } catch (const cv::Exception& e) {
+            std::cerr << "推理错误: " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool fp16;
+    cv::dnn::Net net;
+    std::vector<std::string> outputNames;
+};
+
+#ifdef HAVE_ONNXRUNTIME
+/**
+ * @brief ONNX Runtime CPU后端
+ *
+ * 输入张量直接包装调用方的blob；输入形状与上一次相同时，输出也直接绑定到
+ * 调用方复用的张量上，由ONNX Runtime写入，不再额外复制。
+ */
+class OnnxRuntimeBackend : public InferenceBackend {
+public:
+    OnnxRuntimeBackend()
+        : env(ORT_LOGGING_LEVEL_WARNING, "AICompanion"),
+          memoryInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
+          batchDynamic(false), uint8Input(false) {}
+
+    std::string name() const override { return "onnxruntime"; }
+
+    bool supportsBatch() const override { return batchDynamic; }
+
+    int inputDepth() const override { return uint8Input ? CV_8U : CV_32F; }
+
+    // uint8输入的ONNX模型直接接收原始像素值
+    QuantizationParams inputQuantization() const override {
+        QuantizationParams params;
+        params.scale = 1.0f / 255.0f;
+        return params;
+    }
+
+    // 优化后的网络以ORT格式缓存，下次启动直接加载，跳过图优化
+    void setCachePrefix(const std::string& prefix) override {
+        cachePath = prefix.empty() ? std::string() : prefix + ".ort";
+    }
+
+    bool load(const std::string& modelPath) override {
+        try {
+            bool created = false;
+            if (!cachePath.empty() && fileExists(cachePath)) {
+                try {
+                    createSession(cachePath, true);
+                    created = true;
+                } catch (const Ort::Exception& e) {
+                    // 缓存损坏（例如写入时断电）或运行库版本不匹配：删除后重新优化
+                    std::cerr << "onnxruntime 网络缓存不可用，重新优化: " << e.what() << std::endl;
+                    std::remove(cachePath.c_str());
+                }
+            }
+            if (!created) {
+                createSession(modelPath, false);
+            }
+
+            Ort::AllocatorWithDefaultOptions allocator;
+            inputNames.clear();
+            outputNames.clear();
+            for (size_t i = 0; i < session->GetInputCount(); ++i) {
+                inputNames.push_back(session->GetInputNameAllocated(i, allocator).get());
+            }
+            for (size_t i = 0; i < session->GetOutputCount(); ++i) {
+                outputNames.push_back(session->GetOutputNameAllocated(i, allocator).get());
+            }
+            inputNamePtrs.clear();
+            outputNamePtrs.clear();
+            for (const auto& inputName : inputNames) {
+                inputNamePtrs.push_back(inputName.c_str());
+            }
+            for (const auto& outputName : outputNames) {
+                outputNamePtrs.push_back(outputName.c_str());
+            }
+
+            // 批次维度为动态（-1）时才支持批量输入
+            Ort::TypeInfo inputInfo = session->GetInputTypeInfo(0);
+            std::vector<int64_t> shape = inputInfo.GetTensorTypeAndShapeInfo().GetShape();
+            batchDynamic = !shape.empty() && shape[0] < 0;
+
+            // QDQ/QOperator量化模型的输入输出通常仍为float；输入为uint8时不做归一化
+            const ONNXTensorElementDataType inputType = inputInfo.GetTensorTypeAndShapeInfo().GetElementType();
+            if (inputType != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT && inputType != ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+                std::cerr << "onnxruntime 只支持float或uint8输入" << std::endl;
+                return false;
+            }
+            uint8Input = inputType == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+            for (size_t i = 0; i < session->GetOutputCount(); ++i) {
+                if (session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetElementType() !=
+                    ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+                    std::cerr << "onnxruntime 只支持float输出" << std::endl;
+                    return false;
+                }
+            }
+        } catch (const Ort::Exception& e) {
+            std::cerr << "onnxruntime 加载模型失败: " << e.what() << std::endl;
+            session.reset();
+            return false;
+        }
+        return !inputNames.empty() && !outputNames.empty();
+    }
+
+    bool forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        std::vector<int64_t> shape(blob.size.p, blob.size.p + blob.dims);
+        try {
+            Ort::Value input = uint8Input
+                ? Ort::Value::CreateTensor<uint8_t>(memoryInfo, const_cast<uint8_t*>(blob.ptr<uint8_t>()),
+                                                    blob.total(), shape.data(), shape.size())
+                : Ort::Value::CreateTensor<float>(memoryInfo, const_cast<float*>(blob.ptr<float>()),
+                                                  blob.total(), shape.data(), shape.size());
+
+            if (shape == lastInputShape && matchesKnownOutputs(outputs)) {
+                // 形状已知：把输出直接绑定到复用的张量上
+                boundOutputs.clear();
+                for (size_t i = 0; i < outputs.size(); ++i) {
+                    outputShape.assign(outputs[i].size.p, outputs[i].size.p + outputs[i].dims);
+                    boundOutputs.push_back(Ort::Value::CreateTensor<float>(
+                        memoryInfo, outputs[i].ptr<float>(), outputs[i].total(),
+                        outputShape.data(), outputShape.size()));
+                }
+                session->Run(Ort::RunOptions{nullptr}, inputNamePtrs.data(), &input, 1,
+                             outputNamePtrs.data(), boundOutputs.data(), boundOutputs.size());
+                return true;
+            }
+
+            // 第一次推理或输入形状变化：由ONNX Runtime分配输出，复制到复用的张量
+            std::vector<Ort::Value> results = session->Run(Ort::RunOptions{nullptr}, inputNamePtrs.data(),
+                                                           &input, 1, outputNamePtrs.data(),
+                                                           outputNamePtrs.size());
+            outputs.resize(results.size());
+            knownOutputShapes.resize(results.size());
+            for (size_t i = 0; i < results.size(); ++i) {
+                std::vector<int64_t> dims = results[i].GetTensorTypeAndShapeInfo().GetShape();
+                knownOutputShapes[i].assign(dims.begin(), dims.end());
+                outputs[i].create(static_cast<int>(dims.size()), knownOutputShapes[i].data(), CV_32F);
+                std::memcpy(outputs[i].data, results[i].GetTensorData<float>(),
+                            outputs[i].total() * sizeof(float));
+            }
+            lastInputShape = shape;
+        } catch (const Ort::Exception& e) {
+            std::cerr << "推理错误: " << e.what() << std::endl;
+            lastInputShape.clear();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    Ort::Env env;
+    Ort::MemoryInfo memoryInfo;
+    std::unique_ptr<Ort::Session> session;
+    std::vector<std::string> inputNames;
+    std::vector<std::string> outputNames;
+    std::vector<const char*> inputNamePtrs;
+    std::vector<const char*> outputNamePtrs;
+    std::vector<int64_t> lastInputShape;
+    std::vector<int64_t> outputShape;
+    std::vector<Ort::Value> boundOutputs;
+    std::vector<std::vector<int> > knownOutputShapes;  // lastInputShape对应的输出形状
+    bool batchDynamic;
+    bool uint8Input;
+    std::string cachePath;
+
+    static std::basic_string<ORTCHAR_T> ortPath(const std::string& path) {
+        return std::basic_string<ORTCHAR_T>(path.begin(), path.end());
+    }
+
+    // fromCache为true时path是已优化的ORT格式模型；否则在创建会话时把优化结果写入缓存
+    void createSession(const std::string& path, bool fromCache) {
+        Ort::SessionOptions options;
+        options.SetIntraOpNumThreads(workerThreadCount());
+        const std::string pendingPath = cachePath + ".tmp";
+        if (fromCache) {
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            options.AddConfigEntry("session.load_model_format", "ORT");
+        } else {
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            if (!cachePath.empty()) {
+                options.SetOptimizedModelFilePath(ortPath(pendingPath).c_str());
+                options.AddConfigEntry("session.save_model_format", "ORT");
+            }
+        }
+        session.reset(new Ort::Session(env, ortPath(path).c_str(), options));
+        // 先写临时文件再改名，中途断电不会留下不完整的缓存
+        if (!fromCache && !cachePath.empty() && std::rename(pendingPath.c_str(), cachePath.c_str()) != 0) {
+            std::remove(pendingPath.c_str());
+        }
+    }
+
+    // 调用方的张量是否正好是上一次输入形状对应的输出形状（不同调用方可能传入不同的列表）
+    bool matchesKnownOutputs(const std::vector<cv::Mat>& outputs) const {
+        if (outputs.size() != knownOutputShapes.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            const std::vector<int>& known = knownOutputShapes[i];
+            if (outputs[i].type() != CV_32F || outputs[i].dims != static_cast<int>(known.size()) ||
+                !std::equal(known.begin(), known.end(), outputs[i].size.p) || !outputs[i].isContinuous()) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+#endif // HAVE_ONNXRUNTIME
+
+#ifdef HAVE_TFLITE
+/**
+ * @brief x86上的TensorFlow Lite后端（XNNPACK委托）
+ *
+ * 使用与ONNX模型同名的.tflite文件，支持float模型和全整型（uint8/int8）量化模型。
+ * TFLite导出的YOLO模型通常是NHWC输入、归一化（0-1）坐标输出，这里转换为与
+ * 其他后端一致的NCHW输入，归一化坐标由normalizedBoxes()告知解码阶段。
+ * 量化输出保持原始字节，由解码器按outputQuantization()反量化。
+ */
+class TFLiteBackend : public InferenceBackend {
+public:
+    TFLiteBackend() : delegate(nullptr), inputNHWC(false), boxScaleChecked(false), boxesNormalized(false) {}
+
+    ~TFLiteBackend() override {
+        // 解释器必须先于委托释放
+        interpreter.reset();
+        if (delegate) {
+            TfLiteXNNPackDelegateDelete(delegate);
+        }
+    }
+
+    std::string name() const override { return "tflite"; }
+
+    bool supportsBatch() const override { return false; }
+
+    int inputDepth() const override { return depthOf(interpreter->input_tensor(0)->type); }
+
+    QuantizationParams inputQuantization() const override {
+        return paramsOf(interpreter->input_tensor(0));
+    }
+
+    QuantizationParams outputQuantization(size_t index) const override {
+        return paramsOf(interpreter->output_tensor(static_cast<int>(index)));
+    }
+
+    bool normalizedBoxes() const override { return boxesNormalized; }
+
+    bool load(const std::string& modelPath) override {
+        std::string tflitePath = modelPath;
+        size_t dot = tflitePath.find_last_of('.');
+        if (dot != std::string::npos) {
+            tflitePath = tflitePath.substr(0, dot);
+        }
+        tflitePath += ".tflite";
+
+        model = tflite::FlatBufferModel::BuildFromFile(tflitePath.c_str());
+        if (!model) {
+            std::cerr << "tflite 找不到模型文件: " << tflitePath << std::endl;
+            return false;
+        }
+        tflite::ops::builtin::BuiltinOpResolver resolver;
+        tflite::InterpreterBuilder(*model, resolver)(&interpreter);
+        if (!interpreter) {
+            return false;
+        }
+
+        TfLiteXNNPackDelegateOptions options = TfLiteXNNPackDelegateOptionsDefault();
+        options.num_threads = workerThreadCount();
+        delegate = TfLiteXNNPackDelegateCreate(&options);
+        if (interpreter->ModifyGraphWithDelegate(delegate) != kTfLiteOk) {
+            std::cerr << "tflite XNNPACK委托不可用，使用内置内核" << std::endl;
+        }
+        if (interpreter->AllocateTensors() != kTfLiteOk) {
+            return false;
+        }
+
+        const TfLiteTensor* input = interpreter->input_tensor(0);
+        if (depthOf(input->type) < 0 || input->dims->size != 4) {
+            std::cerr << "tflite 只支持float32、uint8或int8的四维输入" << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < interpreter->outputs().size(); ++i) {
+            if (depthOf(interpreter->output_tensor(static_cast<int>(i))->type) < 0) {
+                std::cerr << "tflite 只支持float32、uint8或int8输出" << std::endl;
+                return false;
+            }
+        }
+        inputNHWC = input->dims->data[3] == 3;
+        return true;
+    }
+
+    bool forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        const TfLiteTensor* input = interpreter->input_tensor(0);
+        if (blob.dims != 4 || blob.size[0] != 1 || blob.depth() != depthOf(input->type)) {
+            return false;
+        }
+        const int channels = blob.size[1];
+        const int height = blob.size[2];
+        const int width = blob.size[3];
+        const size_t plane = static_cast<size_t>(height) * width;
+
+        const int expectH = input->dims->data[inputNHWC ? 1 : 2];
+        const int expectW = input->dims->data[inputNHWC ? 2 : 3];
+        if (expectH != height || expectW != width) {
+            std::cerr << "tflite 模型输入尺寸为 " << expectW << "x" << expectH << std::endl;
+            return false;
+        }
+
+        if (inputNHWC) {
+            if (blob.depth() == CV_32F) {
+                planarToInterleaved(blob.ptr<float>(), interpreter->typed_input_tensor<float>(0), plane, channels);
+            } else {
+                planarToInterleaved(blob.ptr<uint8_t>(), input->data.uint8, plane, channels);
+            }
+        } else {
+            std::memcpy(input->data.raw, blob.data, plane * channels * blob.elemSize());
+        }
+
+        if (interpreter->Invoke() != kTfLiteOk) {
+            std::cerr << "推理错误: tflite Invoke失败" << std::endl;
+            return false;
+        }
+
+        const size_t outputCount = interpreter->outputs().size();
+        outputs.resize(outputCount);
+        for (size_t i = 0; i < outputCount; ++i) {
+            const TfLiteTensor* tensor = interpreter->output_tensor(static_cast<int>(i));
+            outputShape.assign(tensor->dims->data, tensor->dims->data + tensor->dims->size);
+            outputs[i].create(static_cast<int>(outputShape.size()), outputShape.data(), depthOf(tensor->type));
+            std::memcpy(outputs[i].data, tensor->data.raw, outputs[i].total() * outputs[i].elemSize());
+        }
+
+        // 第一次推理时判断坐标是否归一化：像素坐标模型的中心点覆盖整个输入，
+        // 与输入内容无关，因此最大中心坐标远大于1
+        if (!boxScaleChecked) {
+            float maxCenter = 0.0f;
+            for (size_t i = 0; i < outputCount; ++i) {
+                maxCenter = std::max(maxCenter, maxBoxCenter(outputs[i], outputQuantization(i)));
+            }
+            boxesNormalized = maxCenter > 0.0f && maxCenter <= 2.0f;
+            boxScaleChecked = true;
+        }
+        return true;
+    }
+
+private:
+    std::unique_ptr<tflite::FlatBufferModel> model;
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    TfLiteDelegate* delegate;
+    bool inputNHWC;
+    bool boxScaleChecked;
+    bool boxesNormalized;
+    std::vector<int> outputShape;
+
+    static int depthOf(TfLiteType type) {
+        switch (type) {
+            case kTfLiteFloat32: return CV_32F;
+            case kTfLiteUInt8: return CV_8U;
+            case kTfLiteInt8: return CV_8S;
+            default: return -1;
+        }
+    }
+
+    static QuantizationParams paramsOf(const TfLiteTensor* tensor) {
+        QuantizationParams params;
+        if (tensor->type == kTfLiteUInt8 || tensor->type == kTfLiteInt8) {
+            params.scale = tensor->params.scale;
+            params.zeroPoint = tensor->params.zero_point;
+            params.isSigned = tensor->type == kTfLiteInt8;
+        }
+        return params;
+    }
+
+    // NCHW平面 → NHWC交错
+    template <typename T>
+    static void planarToInterleaved(const T* src, T* dst, size_t plane, int channels) {
+        for (size_t p = 0; p < plane; ++p) {
+            for (int c = 0; c < channels; ++c) {
+                dst[p * channels + c] = src[c * plane + p];
+            }
+        }
+    }
+
+    // 所有候选框中最大的中心x坐标（按输出布局读取，量化输出先反量化）
+    static float maxBoxCenter(const cv::Mat& output, const QuantizationParams& quant) {
+        if (output.dims < 2) {
+            return 0.0f;
+        }
+        const YOLOOutputLayout layout =
+            detectYOLOLayout(std::vector<int>(output.size.p, output.size.p + output.dims));
+        const size_t cols = static_cast<size_t>(output.size[output.dims - 1]);
+        const int count = layout == YOLOOutputLayout::ChannelsFirst ? output.size[output.dims - 1]
+                                                                    : output.size[output.dims - 2];
+        float maxCenter = 0.0f;
+        for (int i = 0; i < count; ++i) {
+            const size_t offset = layout == YOLOOutputLayout::ChannelsFirst ? i : i * cols;
+            float value = 0.0f;
+            switch (output.depth()) {
+                case CV_8U: value = quant.dequantize(output.ptr<uint8_t>()[offset]); break;
+                case CV_8S: value = quant.dequantize(output.ptr<int8_t>()[offset]); break;
+                default: value = output.ptr<float>()[offset]; break;
+            }
+            maxCenter = std::max(maxCenter, value);
+        }
+        return maxCenter;
+    }
+};
+#endif // HAVE_TFLITE
+
+double medianOf(std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+std::string modelCacheKey(const std::string& modelPath) {
+    std::ifstream file(modelPath.c_str(), std::ios::binary);
+    if (!file.is_open()) {
+        return std::string();
+    }
+    // 64位FNV-1a，按块读取整个文件
+    uint64_t hash = 14695981039346656037ULL;
+    std::vector<char> chunk(1 << 16);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        const std::streamsize count = file.gcount();
+        for (std::streamsize i = 0; i < count; ++i) {
+            hash ^= static_cast<unsigned char>(chunk[static_cast<size_t>(i)]);
+            hash *= 1099511628211ULL;
+        }
+    }
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+cv::Mat makeBackendInput(const InferenceBackend& backend, const std::vector<int>& shape, float value) {
+    const int depth = backend.inputDepth();
+    const double fill = depth == CV_32F ? value : backend.inputQuantization().quantize(value);
+    return cv::Mat(static_cast<int>(shape.size()), shape.data(), depth, cv::Scalar(fill));
+}
+
+std::unique_ptr<InferenceBackend> createInferenceBackend(const std::string& name) {
+    std::unique_ptr<InferenceBackend> backend;
+    if (name == "opencv-cpu") {
+        backend.reset(new OpenCVDnnBackend(false));
+    }
+#ifdef AICOMPANION_HAVE_DNN_CPU_FP16
+    else if (name == "opencv-fp16") {
+        backend.reset(new OpenCVDnnBackend(true));
+    }
+#endif
+#ifdef HAVE_ONNXRUNTIME
+    else if (name == "onnxruntime") {
+        backend.reset(new OnnxRuntimeBackend());
+    }
+#endif
+#ifdef HAVE_TFLITE
+    else if (name == "tflite") {
+        backend.reset(new TFLiteBackend());
+    }
+#endif
+    return backend;
+}
+
+std::vector<std::string> availableInferenceBackends() {
+    std::vector<std::string> names;
+    names.push_back("opencv-cpu");
+#ifdef AICOMPANION_HAVE_DNN_CPU_FP16
+    names.push_back("opencv-fp16");
+#endif
+#ifdef HAVE_ONNXRUNTIME
+    names.push_back("onnxruntime");
+#endif
+#ifdef HAVE_TFLITE
+    names.push_back("tflite");
+#endif
+    return names;
+}
+
+std::unique_ptr<InferenceBackend> selectInferenceBackend(const std::string& modelPath,
+                                                         const std::string& preferred,
+                                                         const std::vector<int>& inputShape,
+                                                         int benchmarkRuns,
+                                                         const std::string& cacheDir,
+                                                         std::vector<BackendBenchmark>& results) {
+    results.clear();
+
+    // 缓存文件以模型内容的哈希命名，模型更新后旧缓存自然失效
+    const std::string key = cacheDir.empty() ? std::string() : modelCacheKey(modelPath);
+    const std::string cachePrefix = key.empty() ? std::string() : cacheDir + "/" + key;
+    auto createBackend = [&cachePrefix](const std::string& name) -> std::unique_ptr<InferenceBackend> {
+        std::unique_ptr<InferenceBackend> backend = createInferenceBackend(name);
+        if (backend && !cachePrefix.empty()) {
+            backend->setCachePrefix(cachePrefix + "-" + name);
+        }
+        return backend;
+    };
+
+    // 指定了后端时直接使用，不测速
+    if (!preferred.empty() && preferred != "auto") {
+        std::unique_ptr<InferenceBackend> backend = createBackend(preferred);
+        BackendBenchmark result;
+        result.name = preferred;
+        result.loaded = backend && backend->load(modelPath);
+        result.medianMs = 0.0;
+        result.cached = false;
+        results.push_back(result);
+        if (result.loaded) {
+            return backend;
+        }
+        std::cerr << "推理后端 " << preferred << " 不可用，改为自动选择" << std::endl;
+        results.clear();
+    }
+
+    // 上一次启动已经为这个模型选出了后端：直接使用，跳过逐个测速
+    const std::string selectionPath = cachePrefix.empty() ? std::string() : cachePrefix + ".backend";
+    if (!selectionPath.empty()) {
+        std::ifstream selectionFile(selectionPath.c_str());
+        BackendBenchmark result;
+        result.loaded = false;
+        result.cached = true;
+        if (selectionFile >> result.name >> result.medianMs) {
+            std::unique_ptr<InferenceBackend> backend = createBackend(result.name);
+            result.loaded = backend && backend->load(modelPath);
+            if (result.loaded) {
+                results.push_back(result);
+                return backend;
+            }
+        }
+    }
+
+    // 在实际模型上逐个测速：一次预热（触发延迟初始化和内存分配）后取多次推理的中位耗时
+    cv::Mat blob;
+    std::vector<cv::Mat> outputs;
+    std::vector<double> timings;
+    std::unique_ptr<InferenceBackend> best;
+    double bestMs = 0.0;
+
+    const std::vector<std::string> names = availableInferenceBackends();
+    for (const auto& name : names) {
+        BackendBenchmark result;
+        result.name = name;
+        result.loaded = false;
+        result.medianMs = 0.0;
+        result.cached = false;
+
+        std::unique_ptr<InferenceBackend> backend = createBackend(name);
+        outputs.clear();
+        bool ok = backend && backend->load(modelPath);
+        if (ok) {
+            // 量化模型的输入为uint8/int8，按各自的输入类型构造测速输入
+            blob = makeBackendInput(*backend, inputShape, 114.0f / 255.0f);
+            ok = backend->forward(blob, outputs);
+        }
+        if (ok) {
+            result.loaded = true;
+            timings.clear();
+            for (int i = 0; i < std::max(1, benchmarkRuns) && result.loaded; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                result.loaded = backend->forward(blob, outputs);
+                timings.push_back(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count());
+            }
+            result.medianMs = medianOf(timings);
+        }
+        results.push_back(result);
+
+        if (result.loaded && (!best || result.medianMs < bestMs)) {
+            best = std::move(backend);
+            bestMs = result.medianMs;
+        }
+    }
+
+    // 记录本次的选择；先写临时文件再改名，中途断电不会留下不完整的记录
+    if (best && !selectionPath.empty()) {
+        const std::string pendingPath = selectionPath + ".tmp";
+        std::ofstream selectionFile(pendingPath.c_str());
+        selectionFile << best->name() << " " << bestMs << std::endl;
+        selectionFile.close();
+        if (!selectionFile || std::rename(pendingPath.c_str(), selectionPath.c_str()) != 0) {
+            std::remove(pendingPath.c_str());
+        }
+    }
+    return best;
+}
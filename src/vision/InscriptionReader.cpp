@@ -0,0 +1,555 @@
+#include "vision/InscriptionReader.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace {
+// 任务队列容量，识别跟不上时丢弃最旧的任务（对应的跟踪目标之后重新提交）
+const size_t kMaxPendingTasks = 4;
+
+// 检测框每边向外扩展的比例，避免贴边的笔画被截断
+const float kContextMargin = 0.05f;
+
+// 检测框的边长小于该值（像素）时文字太小，不识别
+const int kMinRegionSize = 24;
+
+// 置信度达到该值后不再重试
+const float kGoodConfidence = 0.8f;
+
+// 每个跟踪目标最多识别的次数，以及两次之间的最短间隔
+const int kMaxAttempts = 3;
+const std::chrono::milliseconds kRetryInterval(1000);
+
+// 竖排时相邻的墨迹块合并后不超过列宽的这一倍数，视为同一个字（例如“二”“三”的笔画）
+const float kCharAspect = 1.2f;
+
+// profile中墨迹多于minInk的连续区间[first, second)，间隔不超过maxGap的区间合并，短于minLength的丢弃
+void findRuns(const std::vector<int>& profile, int minInk, int maxGap, int minLength,
+              std::vector<std::pair<int, int> >& runs) {
+    runs.clear();
+    const int size = static_cast<int>(profile.size());
+    int start = -1;
+    int end = -1;
+    for (int i = 0; i < size; ++i) {
+        if (profile[static_cast<size_t>(i)] <= minInk) {
+            continue;
+        }
+        if (start >= 0 && i - end > maxGap) {
+            if (end - start >= minLength) {
+                runs.push_back(std::make_pair(start, end));
+            }
+            start = -1;
+        }
+        if (start < 0) {
+            start = i;
+        }
+        end = i + 1;
+    }
+    if (start >= 0 && end - start >= minLength) {
+        runs.push_back(std::make_pair(start, end));
+    }
+}
+
+// 输出为 T×N×C（时间步在前，经典CRNN）还是 N×T×C（PP-OCR）
+bool isTimeMajor(const cv::Mat& output, int count) {
+    return output.dims == 3 && output.size[0] != count && output.size[1] == count;
+}
+} // namespace
+
+InscriptionReader::InscriptionReader()
+    : spaceClass(-1), height(48), width(320), batchSupported(true), loaded(false),
+      tasks(kMaxPendingTasks), recognizedLines(0), lineCount(0) {}
+
+InscriptionReader::~InscriptionReader() {
+    unload();
+}
+
+bool InscriptionReader::load(const std::string& modelPath, const std::string& dictPath,
+                             const std::string& backendName, int inputHeight, int inputWidth) {
+    unload();
+    if (inputHeight < 16 || inputWidth < inputHeight) {
+        std::cerr << "文字识别模型的输入尺寸无效: " << inputHeight << "×" << inputWidth << std::endl;
+        return false;
+    }
+
+    std::ifstream dict(dictPath);
+    if (!dict.is_open()) {
+        std::cerr << "无法加载文字识别字典: " << dictPath << std::endl;
+        return false;
+    }
+    std::string character;
+    while (std::getline(dict, character)) {
+        if (!character.empty() && character[character.size() - 1] == '\r') {
+            character.erase(character.size() - 1);
+        }
+        if (!character.empty()) {
+            dictionary.push_back(character);
+        }
+    }
+    if (dictionary.empty()) {
+        std::cerr << "文字识别字典为空: " << dictPath << std::endl;
+        return false;
+    }
+
+    backend = createInferenceBackend(backendName);
+    if (!backend || !backend->load(modelPath)) {
+        std::cerr << "无法加载文字识别模型: " << modelPath << std::endl;
+        unload();
+        return false;
+    }
+    if (backend->inputDepth() != CV_32F) {
+        std::cerr << "文字识别模型需要float输入" << std::endl;
+        unload();
+        return false;
+    }
+
+    // 行张量按每帧的最大行数一次分配，之后每帧只使用前N行
+    height = inputHeight;
+    width = inputWidth;
+    const int shape[] = {kMaxLines, 3, height, width};
+    lineTensor.create(4, shape, CV_32F);
+    batchSupported = backend->supportsBatch();
+
+    // 试推理一行，确认输出的类别数为字典大小加空白类别（PP-OCR的字典另外追加一个空格类别）
+    const int singleShape[] = {1, 3, height, width};
+    cv::Mat probe(4, singleShape, CV_32F, lineTensor.data);
+    std::memset(probe.data, 0, probe.total() * probe.elemSize());
+    const int dictSize = static_cast<int>(dictionary.size());
+    int classes = 0;
+    if (backend->forward(probe, outputs) && !outputs.empty() && outputs[0].dims >= 2) {
+        classes = outputs[0].size[outputs[0].dims - 1];
+    }
+    if (classes != dictSize + 1 && classes != dictSize + 2) {
+        std::cerr << "文字识别模型的输出与字典不一致（" << dictSize << " 个字符）" << std::endl;
+        unload();
+        return false;
+    }
+    spaceClass = classes == dictSize + 2 ? dictSize + 1 : -1;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded = true;
+    }
+    worker = std::thread(&InscriptionReader::readLoop, this);
+    std::cout << "文字识别模型已加载: " << modelPath << "（" << dictSize << " 个字符，输入 "
+              << height << "×" << width << "）" << std::endl;
+    return true;
+}
+
+void InscriptionReader::unload() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded = false;
+    }
+    // 关闭队列后工作线程做完当前任务即退出，剩余的任务被丢弃
+    tasks.close();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    tasks.reset();
+
+    backend.reset();
+    dictionary.clear();
+    outputs.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : texts) {
+        entry.second.pending = false;
+    }
+}
+
+size_t InscriptionReader::submit(int cameraId, const cv::Mat& frame, const std::vector<InscriptionRegion>& regions,
+                                 std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!loaded || frame.empty()) {
+        return 0;
+    }
+
+    ReadTask task;
+    task.cameraId = cameraId;
+    const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+    for (const auto& region : regions) {
+        if (region.trackId < 0 || region.box.width < kMinRegionSize || region.box.height < kMinRegionSize) {
+            continue;
+        }
+        TrackText& entry = texts[std::make_pair(cameraId, region.trackId)];
+        if (entry.pending || entry.attempts >= kMaxAttempts ||
+            (entry.attempts > 0 && (entry.confidence >= kGoodConfidence || now - entry.lastAttempt < kRetryInterval))) {
+            continue;
+        }
+
+        // 扩展后的区域取整到像素，再裁剪一次避免取整越界
+        const cv::Rect rect = cv::Rect(expandBox(region.box, kContextMargin, frame.size())) & frameRect;
+        if (rect.width < kMinRegionSize || rect.height < kMinRegionSize) {
+            continue;
+        }
+
+        // 帧缓冲区会被流水线复用，只复制检测框所在的区域
+        Crop crop;
+        crop.trackId = region.trackId;
+        crop.image = frame(rect).clone();
+        task.crops.push_back(crop);
+        entry.pending = true;
+        ++entry.attempts;
+        entry.lastAttempt = now;
+    }
+    if (task.crops.empty()) {
+        return 0;
+    }
+
+    ReadTask dropped;
+    if (tasks.push(task, &dropped)) {
+        // 被丢弃的任务不计入识别次数，之后重新提交
+        for (const auto& crop : dropped.crops) {
+            auto it = texts.find(std::make_pair(dropped.cameraId, crop.trackId));
+            if (it != texts.end() && it->second.pending) {
+                it->second.pending = false;
+                --it->second.attempts;
+            }
+        }
+    }
+    return task.crops.size();
+}
+
+void InscriptionReader::retainTracks(int cameraId, const std::vector<int>& activeTrackIds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = texts.begin(); it != texts.end();) {
+        if (it->first.first == cameraId &&
+            std::find(activeTrackIds.begin(), activeTrackIds.end(), it->first.second) == activeTrackIds.end()) {
+            texts.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool InscriptionReader::getText(int cameraId, int trackId, std::string& text, float& confidence) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = texts.find(std::make_pair(cameraId, trackId));
+    if (it == texts.end() || it->second.text.empty()) {
+        return false;
+    }
+    text = it->second.text;
+    confidence = it->second.confidence;
+    return true;
+}
+
+void InscriptionReader::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    texts.clear();
+}
+
+void InscriptionReader::readLoop() {
+    ReadTask task;
+    while (tasks.pop(task)) {
+        try {
+            read(task);
+        } catch (const cv::Exception& e) {
+            std::cerr << "文字识别失败: " << e.what() << std::endl;
+            cropChars.assign(task.crops.size(), 0);
+        }
+        finish(task);
+
+        // 尽早释放复制出的区域
+        task = ReadTask();
+    }
+}
+
+void InscriptionReader::read(const ReadTask& task) {
+    const size_t cropCount = task.crops.size();
+    cropTexts.resize(cropCount);
+    for (auto& text : cropTexts) {
+        text.clear();
+    }
+    cropScores.assign(cropCount, 0.0f);
+    cropChars.assign(cropCount, 0);
+
+    // 第一步：找出所有区域中的文字行，写入行张量
+    lineCount = 0;
+    backgrounds.clear();
+    for (size_t i = 0; i < cropCount; ++i) {
+        backgrounds.push_back(segmentLines(task.crops[i].image, static_cast<int>(i)));
+    }
+    const int count = static_cast<int>(lineCount);
+    if (count == 0) {
+        return;
+    }
+    for (int j = 0; j < count; ++j) {
+        const TextLine& line = lines[static_cast<size_t>(j)];
+        writeLine(task.crops[static_cast<size_t>(line.owner)].image, line,
+                  backgrounds[static_cast<size_t>(line.owner)], j);
+    }
+
+    // 第二步：所有文字行一次批量前向推理；模型不支持动态批次时逐行推理
+    if (batchSupported && count > 1) {
+        const int shape[] = {count, 3, height, width};
+        cv::Mat batch(4, shape, CV_32F, lineTensor.data);
+        if (backend->forward(batch, outputs) && !outputs.empty() && outputs[0].dims == 3) {
+            const bool timeMajor = isTimeMajor(outputs[0], count);
+            if (timeMajor || outputs[0].size[0] == count) {
+                for (int j = 0; j < count; ++j) {
+                    decodeLine(outputs[0], j, timeMajor, lines[static_cast<size_t>(j)].owner);
+                }
+                return;
+            }
+        }
+        std::cerr << "文字识别模型不支持批量推理，改为逐行推理" << std::endl;
+        batchSupported = false;
+    }
+
+    const int singleShape[] = {1, 3, height, width};
+    const size_t lineFloats = static_cast<size_t>(3) * height * width;
+    for (int j = 0; j < count; ++j) {
+        cv::Mat single(4, singleShape, CV_32F, lineTensor.ptr<float>() + lineFloats * j);
+        if (!backend->forward(single, outputs) || outputs.empty() || outputs[0].dims < 2) {
+            return;
+        }
+        decodeLine(outputs[0], 0, isTimeMajor(outputs[0], 1), lines[static_cast<size_t>(j)].owner);
+    }
+}
+
+cv::Scalar InscriptionReader::segmentLines(const cv::Mat& crop, int owner) {
+    const int cropWidth = crop.cols;
+    const int cropHeight = crop.rows;
+
+    // Otsu二值化，占少数的一类是墨迹：拓片是黑底白字，纸本书法是白底黑字
+    cv::cvtColor(crop, gray, cv::COLOR_BGR2GRAY);
+    cv::threshold(gray, binary, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+    const uchar ink = cv::countNonZero(binary) * 2 > cropWidth * cropHeight ? 0 : 255;
+
+    // 墨迹在各列、各行上的投影，同时统计背景的平均颜色（拼接文字行时用来填充空隙）
+    columnInk.assign(static_cast<size_t>(cropWidth), 0);
+    rowInk.assign(static_cast<size_t>(cropHeight), 0);
+    double background[3] = {0.0, 0.0, 0.0};
+    size_t backgroundPixels = 0;
+    for (int y = 0; y < cropHeight; ++y) {
+        const uchar* mask = binary.ptr<uchar>(y);
+        const uchar* pixel = crop.ptr<uchar>(y);
+        for (int x = 0; x < cropWidth; ++x, pixel += 3) {
+            if (mask[x] == ink) {
+                ++columnInk[static_cast<size_t>(x)];
+                ++rowInk[static_cast<size_t>(y)];
+            } else {
+                background[0] += pixel[0];
+                background[1] += pixel[1];
+                background[2] += pixel[2];
+                ++backgroundPixels;
+            }
+        }
+    }
+    const double pixels = backgroundPixels > 0 ? static_cast<double>(backgroundPixels) : 1.0;
+    const cv::Scalar backgroundColor(background[0] / pixels, background[1] / pixels, background[2] / pixels);
+
+    // 有两列以上文字时按竖排（碑刻和书法的传统版式）；只有横向的间隔时按横排；
+    // 都没有间隔时整块作为一行，按宽高比判断方向。行列都对齐的格子版式也按竖排读
+    findRuns(columnInk, std::max(1, cropHeight / 50), 1, 2, runs);
+    findRuns(rowInk, std::max(1, cropWidth / 50), 1, 2, pieceRuns);
+    const bool vertical = runs.size() >= 2 || (pieceRuns.size() <= 1 && cropHeight > cropWidth);
+    if (!vertical) {
+        runs.swap(pieceRuns);
+    }
+
+    // 太细的列（行）是噪点或边框
+    int thickest = 0;
+    for (const auto& run : runs) {
+        thickest = std::max(thickest, run.second - run.first);
+    }
+    const int minThickness = std::max(3, static_cast<int>(thickest * 0.3f));
+
+    // 竖排从右到左读，横排从上到下读
+    for (size_t k = 0; k < runs.size() && lineCount < static_cast<size_t>(kMaxLines); ++k) {
+        const std::pair<int, int> run = vertical ? runs[runs.size() - 1 - k] : runs[k];
+        const int thickness = run.second - run.first;
+        if (thickness < minThickness) {
+            continue;
+        }
+        if (lines.size() <= lineCount) {
+            lines.resize(lineCount + 1);
+        }
+        TextLine& line = lines[lineCount];
+        line.owner = owner;
+        line.pieces.clear();
+
+        if (vertical) {
+            // 列内按行投影切出各个字，从上到下排成一行
+            rowInk.assign(static_cast<size_t>(cropHeight), 0);
+            for (int y = 0; y < cropHeight; ++y) {
+                const uchar* mask = binary.ptr<uchar>(y);
+                for (int x = run.first; x < run.second; ++x) {
+                    if (mask[x] == ink) {
+                        ++rowInk[static_cast<size_t>(y)];
+                    }
+                }
+            }
+            findRuns(rowInk, 0, std::max(1, thickness / 10), 1, pieceRuns);
+            int charStart = -1;
+            int charEnd = -1;
+            for (const auto& piece : pieceRuns) {
+                if (charStart >= 0 && piece.second - charStart <= thickness * kCharAspect) {
+                    charEnd = piece.second;
+                    continue;
+                }
+                if (charStart >= 0) {
+                    line.pieces.push_back(cv::Rect(run.first, charStart, thickness, charEnd - charStart));
+                }
+                charStart = piece.first;
+                charEnd = piece.second;
+            }
+            if (charStart >= 0) {
+                line.pieces.push_back(cv::Rect(run.first, charStart, thickness, charEnd - charStart));
+            }
+        } else {
+            // 横排的一行整体作为一块，只收紧左右两端
+            int left = cropWidth;
+            int right = 0;
+            for (int y = run.first; y < run.second; ++y) {
+                const uchar* mask = binary.ptr<uchar>(y);
+                for (int x = 0; x < cropWidth; ++x) {
+                    if (mask[x] == ink) {
+                        left = std::min(left, x);
+                        right = std::max(right, x + 1);
+                    }
+                }
+            }
+            if (right > left) {
+                line.pieces.push_back(cv::Rect(left, run.first, right - left, thickness));
+            }
+        }
+        if (!line.pieces.empty()) {
+            ++lineCount;
+        }
+    }
+    return backgroundColor;
+}
+
+void InscriptionReader::writeLine(const cv::Mat& crop, const TextLine& line, const cv::Scalar& background,
+                                  int index) {
+    // 各块按同一比例缩放（最高的一块与输入等高），保留字与字之间的大小关系，块之间留出空隙
+    int tallest = 1;
+    for (const auto& piece : line.pieces) {
+        tallest = std::max(tallest, piece.height);
+    }
+    const float scale = static_cast<float>(height) / tallest;
+    const int gap = line.pieces.size() > 1 ? height / 8 : 0;
+    int total = 0;
+    for (const auto& piece : line.pieces) {
+        total += std::max(1, static_cast<int>(std::lround(piece.width * scale))) + gap;
+    }
+    total = std::max(1, total - gap);
+
+    lineImage.create(height, total, CV_8UC3);
+    lineImage.setTo(background);
+    int x = 0;
+    for (const auto& piece : line.pieces) {
+        const int pieceWidth = std::min(total - x, std::max(1, static_cast<int>(std::lround(piece.width * scale))));
+        const int pieceHeight = std::min(height, std::max(1, static_cast<int>(std::lround(piece.height * scale))));
+        if (pieceWidth <= 0) {
+            break;
+        }
+        cv::resize(crop(piece), resized, cv::Size(pieceWidth, pieceHeight), 0, 0,
+                   scale < 1.0f ? cv::INTER_AREA : cv::INTER_LINEAR);
+        cv::Mat target = lineImage(cv::Rect(x, (height - pieceHeight) / 2, pieceWidth, pieceHeight));
+        resized.copyTo(target);
+        x += pieceWidth + gap;
+    }
+
+    // 超出输入宽度时横向压缩，不足的部分补0（归一化后的中性灰）
+    const cv::Mat* source = &lineImage;
+    if (total > width) {
+        cv::resize(lineImage, resized, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+        source = &resized;
+        total = width;
+    }
+
+    // PP-OCR的识别模型直接使用BGR顺序，归一化到[-1, 1]
+    const size_t plane = static_cast<size_t>(height) * width;
+    float* dst = lineTensor.ptr<float>() + plane * 3 * index;
+    for (int c = 0; c < 3; ++c) {
+        for (int y = 0; y < height; ++y) {
+            const uchar* pixel = source->ptr<uchar>(y) + c;
+            float* out = dst + plane * c + static_cast<size_t>(y) * width;
+            for (int col = 0; col < total; ++col, pixel += 3) {
+                out[col] = *pixel / 127.5f - 1.0f;
+            }
+            std::fill(out + total, out + width, 0.0f);
+        }
+    }
+}
+
+void InscriptionReader::decodeLine(const cv::Mat& output, int row, bool timeMajor, int owner) {
+    const size_t classes = static_cast<size_t>(output.size[output.dims - 1]);
+    int steps = output.size[0];
+    size_t rowOffset = 0;
+    size_t stepStride = classes;
+    if (output.dims == 3) {
+        if (timeMajor) {
+            rowOffset = classes * static_cast<size_t>(row);
+            stepStride = classes * static_cast<size_t>(output.size[1]);
+        } else {
+            steps = output.size[1];
+            rowOffset = classes * static_cast<size_t>(steps) * static_cast<size_t>(row);
+        }
+    }
+
+    const QuantizationParams quantization = backend->outputQuantization(0);
+    std::string& text = cropTexts[static_cast<size_t>(owner)];
+    step.resize(classes);
+    size_t previous = 0;
+    int chars = 0;
+    for (int t = 0; t < steps; ++t) {
+        const size_t offset = rowOffset + stepStride * static_cast<size_t>(t);
+        if (output.depth() == CV_32F) {
+            const float* values = output.ptr<float>() + offset;
+            std::copy(values, values + classes, step.begin());
+        } else {
+            for (size_t i = 0; i < classes; ++i) {
+                step[i] = quantization.dequantize(output.depth() == CV_8S
+                    ? static_cast<int>(reinterpret_cast<const int8_t*>(output.data)[offset + i])
+                    : static_cast<int>(output.data[offset + i]));
+            }
+        }
+
+        // 贪心解码：取每个时间步分数最高的类别，合并连续重复的类别并去掉空白
+        const size_t best = static_cast<size_t>(std::max_element(step.begin(), step.end()) - step.begin());
+        if (best != 0 && best != previous) {
+            // logits或log-softmax先转换为概率
+            toProbabilities(step.data(), classes);
+            const float probability = step[best];
+            if (static_cast<int>(best) == spaceClass) {
+                text += ' ';
+            } else if (best - 1 < dictionary.size()) {
+                text += dictionary[best - 1];
+            }
+            cropScores[static_cast<size_t>(owner)] += probability;
+            ++chars;
+        }
+        previous = best;
+    }
+    if (chars > 0) {
+        cropChars[static_cast<size_t>(owner)] += chars;
+        ++recognizedLines;
+    }
+}
+
+void InscriptionReader::finish(const ReadTask& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < task.crops.size(); ++i) {
+        auto it = texts.find(std::make_pair(task.cameraId, task.crops[i].trackId));
+        if (it == texts.end()) {
+            continue;   // 识别期间跟踪已经结束
+        }
+        TrackText& entry = it->second;
+        entry.pending = false;
+        if (i >= cropChars.size() || cropChars[i] == 0) {
+            continue;
+        }
+        const float confidence = cropScores[i] / cropChars[i];
+        if (entry.text.empty() || confidence > entry.confidence) {
+            entry.text = cropTexts[i];
+            entry.confidence = confidence;
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include "vision/ObjectTracker.h"
+#include <algorithm>
+#include <cmath>
+#include "vision/model_utils.h"
+
+namespace {
+
+// 状态：[cx, cy, 面积, 宽高比, vx, vy, v面积]，观测：[cx, cy, 面积, 宽高比]
+const int kStateSize = 7;
+const int kMeasurementSize = 4;
+
+void boxToMeasurement(const cv::Rect& box, cv::Mat& z) {
+    z.at<float>(0) = box.x + box.width * 0.5f;
+    z.at<float>(1) = box.y + box.height * 0.5f;
+    z.at<float>(2) = static_cast<float>(box.width) * box.height;
+    z.at<float>(3) = box.height > 0 ? static_cast<float>(box.width) / box.height : 1.0f;
+}
+
+cv::Rect stateToBox(const cv::Mat& state) {
+    const float area = std::max(state.at<float>(2), 1.0f);
+    const float ratio = std::max(state.at<float>(3), 1e-3f);
+    const float w = std::sqrt(area * ratio);
+    const float h = area / w;
+    return cv::Rect(static_cast<int>(state.at<float>(0) - w * 0.5f),
+                    static_cast<int>(state.at<float>(1) - h * 0.5f),
+                    static_cast<int>(w), static_cast<int>(h));
+}
+
+} // namespace
+
+ObjectTracker::ObjectTracker(const ObjectTrackerConfig& config)
+    : config(config), nextTrackId(1), lostInLastUpdate(false) {
+}
+
+void ObjectTracker::clear() {
+    tracks.clear();
+    lostInLastUpdate = false;
+}
+
+void ObjectTracker::initTrack(Track& track, const cv::Rect& box, int classId, float score) {
+    track.info.trackId = nextTrackId++;
+    track.info.classId = classId;
+    track.info.score = score;
+    track.info.box = box;
+    track.info.hits = 1;
+    track.info.misses = 0;
+    track.info.confirmed = config.minHits <= 1;
+
+    // 恒速模型：位置和面积按各自的速度推进，宽高比保持不变
+    cv::KalmanFilter& kf = track.kalman;
+    kf.init(kStateSize, kMeasurementSize, 0, CV_32F);
+    cv::setIdentity(kf.transitionMatrix);
+    kf.transitionMatrix.at<float>(0, 4) = 1.0f;
+    kf.transitionMatrix.at<float>(1, 5) = 1.0f;
+    kf.transitionMatrix.at<float>(2, 6) = 1.0f;
+    cv::setIdentity(kf.measurementMatrix);
+
+    // 噪声参数沿用SORT的取值：速度初始不确定性大，面积和宽高比的观测噪声大
+    cv::setIdentity(kf.processNoiseCov, cv::Scalar(1.0f));
+    kf.processNoiseCov.at<float>(4, 4) = 0.01f;
+    kf.processNoiseCov.at<float>(5, 5) = 0.01f;
+    kf.processNoiseCov.at<float>(6, 6) = 1e-4f;
+    cv::setIdentity(kf.measurementNoiseCov, cv::Scalar(1.0f));
+    kf.measurementNoiseCov.at<float>(2, 2) = 10.0f;
+    kf.measurementNoiseCov.at<float>(3, 3) = 10.0f;
+    cv::setIdentity(kf.errorCovPost, cv::Scalar(10.0f));
+    for (int i = 4; i < kStateSize; ++i) {
+        kf.errorCovPost.at<float>(i, i) = 1e4f;
+    }
+
+    track.measurement = cv::Mat::zeros(kMeasurementSize, 1, CV_32F);
+    boxToMeasurement(box, track.measurement);
+    kf.statePost = cv::Mat::zeros(kStateSize, 1, CV_32F);
+    for (int i = 0; i < kMeasurementSize; ++i) {
+        kf.statePost.at<float>(i) = track.measurement.at<float>(i);
+    }
+}
+
+void ObjectTracker::predictTrack(Track& track) {
+    // 面积不能预测为负数
+    cv::Mat& state = track.kalman.statePost;
+    if (state.at<float>(2) + state.at<float>(6) <= 0.0f) {
+        state.at<float>(6) = 0.0f;
+    }
+    track.info.box = stateToBox(track.kalman.predict());
+}
+
+void ObjectTracker::correctTrack(Track& track, const cv::Rect& box) {
+    boxToMeasurement(box, track.measurement);
+    track.info.box = stateToBox(track.kalman.correct(track.measurement));
+}
+
+void ObjectTracker::predict() {
+    for (auto& track : tracks) {
+        predictTrack(track);
+    }
+}
+
+void ObjectTracker::update(const std::vector<cv::Rect>& boxes,
+                           const std::vector<float>& scores,
+                           const std::vector<int>& classIds) {
+    predict();
+
+    // 计算同类别的轨迹与检测框之间的IoU，按IoU从高到低贪心匹配
+    candidates.clear();
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        for (size_t d = 0; d < boxes.size(); ++d) {
+            if (tracks[t].info.classId != classIds[d]) {
+                continue;
+            }
+            float iou = calculateIoU(tracks[t].info.box, boxes[d]);
+            if (iou >= config.iouThreshold) {
+                Candidate candidate;
+                candidate.iou = iou;
+                candidate.track = static_cast<int>(t);
+                candidate.detection = static_cast<int>(d);
+                candidates.push_back(candidate);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.iou > b.iou;
+    });
+
+    trackMatched.assign(tracks.size(), 0);
+    detectionMatched.assign(boxes.size(), 0);
+    for (const auto& candidate : candidates) {
+        if (trackMatched[candidate.track] || detectionMatched[candidate.detection]) {
+            continue;
+        }
+        trackMatched[candidate.track] = 1;
+        detectionMatched[candidate.detection] = 1;
+
+        Track& track = tracks[candidate.track];
+        correctTrack(track, boxes[candidate.detection]);
+        track.info.score = scores[candidate.detection];
+        track.info.hits++;
+        track.info.misses = 0;
+        if (track.info.hits >= config.minHits) {
+            track.info.confirmed = true;
+        }
+    }
+
+    // 未命中的轨迹累计丢失次数，超过上限后删除
+    lostInLastUpdate = false;
+    const size_t existing = tracks.size();
+    for (size_t t = 0; t < existing; ++t) {
+        if (!trackMatched[t]) {
+            tracks[t].info.misses++;
+            lostInLastUpdate = true;
+        }
+    }
+
+    // 未匹配的检测框建立新轨迹
+    for (size_t d = 0; d < boxes.size(); ++d) {
+        if (!detectionMatched[d]) {
+            tracks.push_back(Track());
+            initTrack(tracks.back(), boxes[d], classIds[d], scores[d]);
+        }
+    }
+
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [this](const Track& track) {
+        return track.info.misses > config.maxMisses;
+    }), tracks.end());
+}
+
+void ObjectTracker::getActiveTracks(std::vector<TrackedObject>& active) const {
+    active.clear();
+    for (const auto& track : tracks) {
+        if (track.info.confirmed && track.info.misses == 0) {
+            active.push_back(track.info);
+        }
+    }
+}
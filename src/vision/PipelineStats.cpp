@@ -0,0 +1,52 @@
+#include "vision/PipelineStats.h"
+#include <algorithm>
+
+void PipelineStats::record(PipelineStage stage, double ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    samples[static_cast<int>(stage)].push_back(ms);
+}
+
+StageLatency PipelineStats::summarize(PipelineStage stage) const {
+    std::vector<double> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = samples[static_cast<int>(stage)];
+    }
+
+    StageLatency latency;
+    if (sorted.empty()) {
+        return latency;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (double value : sorted) {
+        sum += value;
+    }
+    // 最近秩分位数
+    const size_t last = sorted.size() - 1;
+    latency.count = sorted.size();
+    latency.meanMs = sum / sorted.size();
+    latency.p50Ms = sorted[last * 50 / 100];
+    latency.p95Ms = sorted[last * 95 / 100];
+    latency.maxMs = sorted[last];
+    return latency;
+}
+
+void PipelineStats::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& stageSamples : samples) {
+        stageSamples.clear();
+    }
+}
+
+const char* PipelineStats::stageName(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::Capture:     return "采集";
+        case PipelineStage::Preprocess:  return "预处理";
+        case PipelineStage::Inference:   return "推理";
+        case PipelineStage::Postprocess: return "后处理";
+        case PipelineStage::EndToEnd:    return "端到端";
+    }
+    return "";
+}
@@ -0,0 +1,136 @@
+#include "vision/ResolutionController.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+ResolutionController::ResolutionController(const ResolutionControllerConfig& config)
+    : config(config), current(0), smoothedMs(0.0), hasSample(false), skipNextSample(false),
+      framesSinceSwitch(0), overBudgetFrames(0), underBudgetFrames(0), switches(0) {}
+
+void ResolutionController::setConfig(const ResolutionControllerConfig& newConfig) {
+    config = newConfig;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+}
+
+void ResolutionController::setSizes(const std::vector<int>& newSizes, int initialSize) {
+    sizes.clear();
+    for (int size : newSizes) {
+        if (size > 0) {
+            sizes.push_back(size);
+        }
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+
+    auto it = std::find(sizes.begin(), sizes.end(), initialSize);
+    current = it != sizes.end() ? static_cast<size_t>(it - sizes.begin())
+                                : (sizes.empty() ? 0 : sizes.size() - 1);
+    hasSample = false;
+    skipNextSample = false;
+    framesSinceSwitch = 0;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    switches = 0;
+}
+
+int ResolutionController::update(int inputSize, double inferenceMs, float cpuLoad) {
+    if (sizes.empty()) {
+        return inputSize;
+    }
+    // 切换前已经预处理好的帧仍是旧尺寸，它们的耗时不代表当前尺寸
+    if (inputSize != sizes[current]) {
+        return sizes[current];
+    }
+    if (skipNextSample) {
+        skipNextSample = false;
+        return sizes[current];
+    }
+
+    if (!hasSample) {
+        smoothedMs = inferenceMs;
+        hasSample = true;
+    } else {
+        smoothedMs += config.smoothing * (inferenceMs - smoothedMs);
+    }
+    ++framesSinceSwitch;
+
+    const double budget = config.budgetMs;
+    overBudgetFrames = smoothedMs > budget * config.downscaleRatio ? overBudgetFrames + 1 : 0;
+
+    // 推理耗时大致与输入面积成正比，按当前尺寸的实测延迟推算上一档的延迟；
+    // CPU被其他进程占满时实测延迟会偏乐观，不升档
+    bool canUpscale = false;
+    if (current + 1 < sizes.size() && !(cpuLoad >= config.highCpuLoad)) {
+        const double ratio = static_cast<double>(sizes[current + 1]) / sizes[current];
+        canUpscale = smoothedMs * ratio * ratio < budget * config.upscaleRatio;
+    }
+    underBudgetFrames = canUpscale ? underBudgetFrames + 1 : 0;
+
+    // 超出预算时尽快降档（不等冷却期），升档则要等冷却期过后
+    if (current > 0 && overBudgetFrames >= config.switchFrames) {
+        switchTo(current - 1);
+    } else if (canUpscale && underBudgetFrames >= config.switchFrames &&
+               framesSinceSwitch >= config.cooldownFrames) {
+        switchTo(current + 1);
+    }
+    return sizes[current];
+}
+
+int ResolutionController::currentSize() const {
+    return sizes.empty() ? 0 : sizes[current];
+}
+
+double ResolutionController::smoothedLatencyMs() const {
+    return hasSample ? smoothedMs : 0.0;
+}
+
+void ResolutionController::switchTo(size_t index) {
+    current = index;
+    hasSample = false;
+    skipNextSample = true;
+    framesSinceSwitch = 0;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    ++switches;
+}
+
+CpuLoadMonitor::CpuLoadMonitor(int minIntervalMs)
+    : minInterval(minIntervalMs), lastBusy(0), lastTotal(0), hasBaseline(false), lastLoad(-1.0f) {}
+
+float CpuLoadMonitor::sample() {
+#ifdef __linux__
+    auto now = std::chrono::steady_clock::now();
+    if (hasBaseline && now - lastSample < minInterval) {
+        return lastLoad;
+    }
+
+    // 第一行为所有CPU的累计时间：user nice system idle iowait irq softirq steal ...
+    std::ifstream stat("/proc/stat");
+    std::string label;
+    if (!(stat >> label) || label != "cpu") {
+        return -1.0f;
+    }
+    uint64_t total = 0;
+    uint64_t idle = 0;
+    uint64_t value = 0;
+    for (int field = 0; field < 8 && stat >> value; ++field) {
+        total += value;
+        if (field == 3 || field == 4) {
+            idle += value;
+        }
+    }
+    const uint64_t busy = total - idle;
+
+    if (hasBaseline && total > lastTotal) {
+        lastLoad = static_cast<float>(busy - lastBusy) / static_cast<float>(total - lastTotal);
+    }
+    lastBusy = busy;
+    lastTotal = total;
+    lastSample = now;
+    hasBaseline = true;
+    return lastLoad;
+#else
+    return -1.0f;
+#endif
+}
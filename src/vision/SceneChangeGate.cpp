@@ -0,0 +1,92 @@
+#include "vision/SceneChangeGate.h"
+#include <cmath>
+#include <cstdlib>
+
+SceneChangeGate::SceneChangeGate(const SceneChangeGateConfig& config)
+    : config(config), hasReference(false), lastDiff(0.0f), lastHistDistance(0.0f) {
+    for (int i = 0; i < kHistogramBins; ++i) {
+        referenceHist[i] = 0.0f;
+    }
+}
+
+void SceneChangeGate::setConfig(const SceneChangeGateConfig& newConfig) {
+    config = newConfig;
+    reset();
+}
+
+void SceneChangeGate::reset() {
+    hasReference = false;
+}
+
+void SceneChangeGate::computeThumbnail(const cv::Mat& frame) {
+    // 区域平均缩小，本身就有去噪效果，对传感器噪声不敏感
+    cv::resize(frame, thumb, cv::Size(config.thumbWidth, config.thumbHeight), 0, 0, cv::INTER_AREA);
+
+    const size_t pixelCount = static_cast<size_t>(thumb.rows) * thumb.cols;
+    current.resize(pixelCount);
+    const int channels = thumb.channels();
+    for (int y = 0; y < thumb.rows; ++y) {
+        const uchar* src = thumb.ptr<uchar>(y);
+        uint8_t* dst = current.data() + static_cast<size_t>(y) * thumb.cols;
+        if (channels == 1) {
+            for (int x = 0; x < thumb.cols; ++x) {
+                dst[x] = src[x];
+            }
+        } else {
+            // BGR → 灰度（整数近似 0.114B + 0.587G + 0.299R）
+            for (int x = 0; x < thumb.cols; ++x) {
+                const uchar* p = src + x * channels;
+                dst[x] = static_cast<uint8_t>((29 * p[0] + 150 * p[1] + 77 * p[2]) >> 8);
+            }
+        }
+    }
+}
+
+bool SceneChangeGate::shouldInfer(const cv::Mat& frame, std::chrono::steady_clock::time_point now) {
+    if (frame.empty()) {
+        return false;
+    }
+
+    computeThumbnail(frame);
+
+    // 当前缩略图的归一化直方图
+    float hist[kHistogramBins] = {0.0f};
+    const size_t pixelCount = current.size();
+    for (size_t i = 0; i < pixelCount; ++i) {
+        hist[current[i] * kHistogramBins / 256] += 1.0f;
+    }
+    const float invCount = pixelCount > 0 ? 1.0f / pixelCount : 0.0f;
+    for (int i = 0; i < kHistogramBins; ++i) {
+        hist[i] *= invCount;
+    }
+
+    bool fire = !hasReference || reference.size() != pixelCount;
+    if (!fire) {
+        // 帧差：缩略图的平均绝对灰度差，反映局部运动
+        unsigned long sum = 0;
+        for (size_t i = 0; i < pixelCount; ++i) {
+            sum += static_cast<unsigned long>(std::abs(static_cast<int>(current[i]) - reference[i]));
+        }
+        lastDiff = pixelCount > 0 ? static_cast<float>(sum) / pixelCount : 0.0f;
+
+        // 直方图距离：反映整体亮度和内容的变化（如转向另一件展品）
+        float distance = 0.0f;
+        for (int i = 0; i < kHistogramBins; ++i) {
+            distance += std::fabs(hist[i] - referenceHist[i]);
+        }
+        lastHistDistance = distance;
+
+        const bool stale = now - lastInference >= std::chrono::milliseconds(config.maxStaleMs);
+        fire = stale || lastDiff > config.diffThreshold || lastHistDistance > config.histogramThreshold;
+    }
+
+    if (fire) {
+        reference.swap(current);
+        for (int i = 0; i < kHistogramBins; ++i) {
+            referenceHist[i] = hist[i];
+        }
+        hasReference = true;
+        lastInference = now;
+    }
+    return fire;
+}
@@ -0,0 +1,292 @@
+#include "vision/VisionBenchmark.h"
+#include "vision/VisionProcessor.h"
+#include "vision/model_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+#ifndef ESP32
+namespace {
+
+// 不会读完的来源（摄像头、模拟摄像头）在未指定时长时的默认运行时间
+const double kDefaultEndlessSeconds = 10.0;
+
+bool isEndlessSource(const std::string& source) {
+    return source.empty() || source == "synthetic" || source.compare(0, 7, "camera:") == 0;
+}
+
+void printLatencyRow(const VisionProcessor& processor, PipelineStage stage) {
+    StageLatency latency = processor.getStageLatency(stage);
+    std::cout << "  " << std::left << std::setw(10) << PipelineStats::stageName(stage) << std::right
+              << std::setw(8) << latency.count
+              << std::setw(10) << latency.meanMs
+              << std::setw(10) << latency.p50Ms
+              << std::setw(10) << latency.p95Ms
+              << std::setw(10) << latency.maxMs << std::endl;
+}
+
+// 原来的贪心NMS：每轮线性查找最高分的框，再与剩余的框逐个计算IoU，用作对照
+std::vector<int> legacyNMS(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                           const std::vector<int>& candidates, float nmsThreshold) {
+    std::vector<int> indices;
+    std::vector<int> candidateIndices = candidates;
+    while (!candidateIndices.empty()) {
+        int bestIdx = 0;
+        float bestScore = scores[candidateIndices[bestIdx]];
+        for (size_t i = 1; i < candidateIndices.size(); ++i) {
+            if (scores[candidateIndices[i]] > bestScore) {
+                bestScore = scores[candidateIndices[i]];
+                bestIdx = static_cast<int>(i);
+            }
+        }
+        int bestCandidateIdx = candidateIndices[bestIdx];
+        indices.push_back(bestCandidateIdx);
+        candidateIndices.erase(candidateIndices.begin() + bestIdx);
+
+        std::vector<int> newCandidateIndices;
+        for (int idx : candidateIndices) {
+            if (calculateIoU(boxes[bestCandidateIdx], boxes[idx]) < nmsThreshold) {
+                newCandidateIndices.push_back(idx);
+            }
+        }
+        candidateIndices = newCandidateIndices;
+    }
+    return indices;
+}
+
+// 原来的实现不区分类别；按类别抑制时对每个类别的候选框分别运行一次
+std::vector<int> legacyNMS(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                           const std::vector<int>& classIds, int classCount, bool perClass, float nmsThreshold) {
+    std::vector<int> indices;
+    if (!perClass) {
+        std::vector<int> all(boxes.size());
+        for (size_t i = 0; i < all.size(); ++i) {
+            all[i] = static_cast<int>(i);
+        }
+        return legacyNMS(boxes, scores, all, nmsThreshold);
+    }
+    for (int classId = 0; classId < classCount; ++classId) {
+        std::vector<int> members;
+        for (size_t i = 0; i < classIds.size(); ++i) {
+            if (classIds[i] == classId) {
+                members.push_back(static_cast<int>(i));
+            }
+        }
+        std::vector<int> kept = legacyNMS(boxes, scores, members, nmsThreshold);
+        indices.insert(indices.end(), kept.begin(), kept.end());
+    }
+    return indices;
+}
+
+// 在640x640的画面内生成聚集在若干目标附近的候选框，与检测头输出的重叠情况相近
+void generateCandidates(int count, int classCount, unsigned int seed, std::vector<cv::Rect>& boxes,
+                        std::vector<float>& scores, std::vector<int>& classIds) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> center(0, 639);
+    std::uniform_int_distribution<int> size(16, 160);
+    std::normal_distribution<float> jitter(0.0f, 8.0f);
+    std::uniform_real_distribution<float> score(0.01f, 1.0f);
+    std::uniform_int_distribution<int> classId(0, classCount - 1);
+
+    const int objectCount = std::max(1, count / 20);
+    std::vector<cv::Rect> objects;
+    for (int i = 0; i < objectCount; ++i) {
+        objects.push_back(cv::Rect(center(rng), center(rng), size(rng), size(rng)));
+    }
+
+    boxes.clear();
+    scores.clear();
+    classIds.clear();
+    std::uniform_int_distribution<int> pick(0, objectCount - 1);
+    for (int i = 0; i < count; ++i) {
+        const cv::Rect& object = objects[pick(rng)];
+        const int width = std::max(4, object.width + static_cast<int>(jitter(rng)));
+        const int height = std::max(4, object.height + static_cast<int>(jitter(rng)));
+        boxes.push_back(cv::Rect(object.x + static_cast<int>(jitter(rng)), object.y + static_cast<int>(jitter(rng)),
+                                 width, height));
+        scores.push_back(score(rng));
+        classIds.push_back(classId(rng));
+    }
+}
+
+// 保留的框与顺序无关，排序后比较
+bool sameIndices(std::vector<int> a, std::vector<int> b) {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+} // namespace
+#endif
+
+int runNMSBenchmark(const NMSBenchmarkOptions& options) {
+#ifdef ESP32
+    (void)options;
+    std::cerr << "ESP32平台不支持NMS基准测试" << std::endl;
+    return -1;
+#else
+    const float nmsThreshold = 0.45f;
+    const int repeats = std::max(1, options.repeats);
+    const int classCount = std::max(1, options.classCount);
+    bool allMatched = true;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\n===== NMS基准测试 =====" << std::endl;
+    std::cout << "类别数: " << classCount << "，IoU阈值: " << nmsThreshold << "，随机数种子: " << options.seed
+              << "，新实现重复 " << repeats << " 次" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "候选框" << std::setw(10) << "方式" << std::right
+              << std::setw(8) << "保留" << std::setw(14) << "原实现(ms)" << std::setw(14) << "新实现(ms)"
+              << std::setw(10) << "加速比" << "  结果" << std::endl;
+
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    NMSWorkspace workspace;
+    std::vector<int> indices;
+    for (int count : options.candidateCounts) {
+        if (count <= 0) {
+            continue;
+        }
+        generateCandidates(count, classCount, options.seed, boxes, scores, classIds);
+
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool perClass = pass == 1;
+            const NMSMode mode = perClass ? NMSMode::PerClass : NMSMode::ClassAgnostic;
+
+            // 原实现很慢，只运行一次
+            auto start = std::chrono::steady_clock::now();
+            std::vector<int> expected = legacyNMS(boxes, scores, classIds, classCount, perClass, nmsThreshold);
+            const double legacyMs =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // 先运行一次预热工作区，再计时
+            applyNMS(boxes, scores, classIds, 0.0f, nmsThreshold, mode, workspace, indices);
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeats; ++i) {
+                applyNMS(boxes, scores, classIds, 0.0f, nmsThreshold, mode, workspace, indices);
+            }
+            const double currentMs =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+
+            const bool matched = sameIndices(expected, indices);
+            allMatched = allMatched && matched;
+            std::cout << "  " << std::left << std::setw(10) << count << std::setw(10)
+                      << (perClass ? "按类别" : "不分类别") << std::right << std::setw(8) << indices.size()
+                      << std::setw(14) << legacyMs << std::setw(14) << currentMs
+                      << std::setw(9) << (currentMs > 0.0 ? legacyMs / currentMs : 0.0) << "x"
+                      << "  " << (matched ? "一致" : "不一致") << std::endl;
+        }
+    }
+
+    if (!allMatched) {
+        std::cerr << "NMS结果与原实现不一致" << std::endl;
+        return 1;
+    }
+    return 0;
+#endif
+}
+
+int runVisionBenchmark(const VisionBenchmarkOptions& options) {
+#ifdef ESP32
+    (void)options;
+    std::cerr << "ESP32平台不支持视觉基准测试" << std::endl;
+    return -1;
+#else
+    VisionProcessor processor;
+    processor.setFrameSource(options.source, options.realTime);
+    if (!options.backend.empty()) {
+        processor.setInferenceBackend(options.backend);
+    }
+    if (!options.sceneGate) {
+        SceneChangeGateConfig defaults;
+        processor.setSceneChangeGate(false, defaults.diffThreshold, defaults.histogramThreshold, defaults.maxStaleMs);
+    }
+    if (options.qualityGate) {
+        FrameQualityGateConfig defaults;
+        processor.setQualityGate(true, defaults.minSharpness, defaults.minLuma, defaults.maxLuma, defaults.maxRejectMs);
+    }
+    if (options.detectionInterval > 0) {
+        processor.setDetectionInterval(options.detectionInterval);
+    }
+    if (options.batchSize > 1) {
+        processor.setBatchInference(options.batchSize, 10);
+    }
+    if (!options.cascadeModel.empty()) {
+        processor.setCascadeDetection(true, options.cascadeModel, 320, 30);
+    }
+    if (options.latencyBudgetMs > 0.0f) {
+        processor.setAdaptiveResolution(true, options.latencyBudgetMs, {320, 416, 640});
+    }
+
+    if (!processor.initialize()) {
+        std::cerr << "视觉处理系统初始化失败，无法运行基准测试" << std::endl;
+        return -1;
+    }
+
+    // 模型加载和预热不计入测试时间
+    while (processor.isModelLoading()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!processor.isModelReady()) {
+        std::cout << "未加载模型，测试的是模拟模式下的流水线开销" << std::endl;
+    }
+
+    double maxSeconds = options.maxSeconds;
+    if (maxSeconds <= 0.0 && isEndlessSource(options.source)) {
+        maxSeconds = kDefaultEndlessSeconds;
+    }
+
+    processor.setLatencyRecording(true);
+    const auto start = std::chrono::steady_clock::now();
+    processor.start();
+
+    // 来源读完之后还要等流水线中剩余的帧处理完
+    bool timedOut = false;
+    while (!(processor.isFrameSourceFinished() && processor.isPipelineIdle())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (maxSeconds > 0.0 && elapsed >= maxSeconds) {
+            timedOut = true;
+            break;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    processor.stop();
+
+    const size_t captured = processor.getCapturedFrameCount();
+    const size_t published = processor.getStageLatency(PipelineStage::EndToEnd).count;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n===== 视觉流水线基准测试 =====" << std::endl;
+    std::cout << "回放方式: " << (options.realTime ? "实时" : "尽快回放") << std::endl;
+    std::cout << "推理后端: " << (processor.isModelReady() ? processor.getInferenceBackendName() : "模拟模式") << std::endl;
+    std::cout << "运行时间: " << seconds << " 秒" << (timedOut ? "（达到时长上限）" : "") << std::endl;
+    std::cout << "采集帧数: " << captured << "，完成帧数: " << published
+              << "，丢弃帧数: " << processor.getDroppedFrameCount() << std::endl;
+    std::cout << "门控跳过推理的比例: " << processor.getInferenceSkipRatio() * 100.0f << "%" << std::endl;
+    if (options.qualityGate) {
+        std::cout << "质量门控拒绝的比例: " << processor.getQualityRejectRatio() * 100.0f << "%" << std::endl;
+    }
+    if (!options.cascadeModel.empty()) {
+        std::cout << "级联检测运行完整模型的比例: " << processor.getCascadeEscalationRatio() * 100.0f << "%" << std::endl;
+    }
+    if (options.latencyBudgetMs > 0.0f) {
+        std::cout << "自适应分辨率: 结束时输入尺寸 " << processor.getModelInputSize() << "，切换 "
+                  << processor.getResolutionSwitchCount() << " 次" << std::endl;
+    }
+    std::cout << "端到端帧率: " << (seconds > 0.0 ? published / seconds : 0.0) << " fps" << std::endl;
+    std::cout << "各阶段延迟（毫秒）:" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "阶段" << std::right
+              << std::setw(8) << "帧数" << std::setw(10) << "平均" << std::setw(10) << "P50"
+              << std::setw(10) << "P95" << std::setw(10) << "最大" << std::endl;
+    printLatencyRow(processor, PipelineStage::Capture);
+    printLatencyRow(processor, PipelineStage::Preprocess);
+    printLatencyRow(processor, PipelineStage::Inference);
+    printLatencyRow(processor, PipelineStage::Postprocess);
+    printLatencyRow(processor, PipelineStage::EndToEnd);
+    return 0;
+#endif
+}
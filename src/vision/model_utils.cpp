@@ -3,66 +3,190 @@
 #include <cmath>
 #include <iostream>
 #include "vision/model_utils.h"
+#include "utils/simd.h"
 
 #ifdef ESP32
 // ESP32环境不需要OpenCV
 #else
 #include <opencv2/opencv.hpp>
+#include "vision/yolo_decoder.h"
 #endif
 
+namespace {
+
+// 计算第i个框与 [begin, end) 范围内各框的IoU，IoU不小于阈值的框在位图中标记为被抑制。
+// 比较 inter >= threshold * union 以避免除法
+void suppressOverlaps(NMSWorkspace& ws, size_t i, size_t begin, size_t end, float threshold) {
+    const float* x1 = ws.x1.data();
+    const float* y1 = ws.y1.data();
+    const float* x2 = ws.x2.data();
+    const float* y2 = ws.y2.data();
+    const float* area = ws.area.data();
+    uint64_t* bits = ws.suppressed.data();
+    size_t j = begin;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+    const __m256 bx1 = _mm256_set1_ps(x1[i]);
+    const __m256 by1 = _mm256_set1_ps(y1[i]);
+    const __m256 bx2 = _mm256_set1_ps(x2[i]);
+    const __m256 by2 = _mm256_set1_ps(y2[i]);
+    const __m256 barea = _mm256_set1_ps(area[i]);
+    const __m256 thr = _mm256_set1_ps(threshold);
+    const __m256 zero = _mm256_setzero_ps();
+    for (; j + 8 <= end; j += 8) {
+        __m256 w = _mm256_max_ps(zero, _mm256_sub_ps(_mm256_min_ps(bx2, _mm256_loadu_ps(x2 + j)),
+                                                     _mm256_max_ps(bx1, _mm256_loadu_ps(x1 + j))));
+        __m256 h = _mm256_max_ps(zero, _mm256_sub_ps(_mm256_min_ps(by2, _mm256_loadu_ps(y2 + j)),
+                                                     _mm256_max_ps(by1, _mm256_loadu_ps(y1 + j))));
+        __m256 inter = _mm256_mul_ps(w, h);
+        __m256 uni = _mm256_sub_ps(_mm256_add_ps(barea, _mm256_loadu_ps(area + j)), inter);
+        uint64_t mask = static_cast<uint64_t>(_mm256_movemask_ps(
+            _mm256_cmp_ps(inter, _mm256_mul_ps(thr, uni), _CMP_GE_OQ)));
+        if (mask) {
+            bits[j >> 6] |= mask << (j & 63);
+            if ((j & 63) > 56) {
+                bits[(j >> 6) + 1] |= mask >> (64 - (j & 63));
+            }
+        }
+    }
+#elif defined(AICOMPANION_HAVE_SSE2)
+    const __m128 bx1 = _mm_set1_ps(x1[i]);
+    const __m128 by1 = _mm_set1_ps(y1[i]);
+    const __m128 bx2 = _mm_set1_ps(x2[i]);
+    const __m128 by2 = _mm_set1_ps(y2[i]);
+    const __m128 barea = _mm_set1_ps(area[i]);
+    const __m128 thr = _mm_set1_ps(threshold);
+    const __m128 zero = _mm_setzero_ps();
+    for (; j + 4 <= end; j += 4) {
+        __m128 w = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(bx2, _mm_loadu_ps(x2 + j)),
+                                               _mm_max_ps(bx1, _mm_loadu_ps(x1 + j))));
+        __m128 h = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(by2, _mm_loadu_ps(y2 + j)),
+                                               _mm_max_ps(by1, _mm_loadu_ps(y1 + j))));
+        __m128 inter = _mm_mul_ps(w, h);
+        __m128 uni = _mm_sub_ps(_mm_add_ps(barea, _mm_loadu_ps(area + j)), inter);
+        uint64_t mask = static_cast<uint64_t>(_mm_movemask_ps(_mm_cmpge_ps(inter, _mm_mul_ps(thr, uni))));
+        if (mask) {
+            bits[j >> 6] |= mask << (j & 63);
+            if ((j & 63) > 60) {
+                bits[(j >> 6) + 1] |= mask >> (64 - (j & 63));
+            }
+        }
+    }
+#endif
+
+    for (; j < end; ++j) {
+        float w = std::max(0.0f, std::min(x2[i], x2[j]) - std::max(x1[i], x1[j]));
+        float h = std::max(0.0f, std::min(y2[i], y2[j]) - std::max(y1[i], y1[j]));
+        float inter = w * h;
+        if (inter >= threshold * (area[i] + area[j] - inter)) {
+            bits[j >> 6] |= uint64_t(1) << (j & 63);
+        }
+    }
+}
+
+} // namespace
+
 /**
- * @brief 非最大抑制算法，用于过滤重叠的检测框
+ * @brief 排序 + 位图的O(n log n)非最大抑制，支持按类别抑制
  * @param boxes 检测框列表
  * @param scores 检测框的置信度分数
+ * @param classIds 检测框的类别ID（ClassAgnostic模式下可为空）
  * @param scoreThreshold 分数阈值
  * @param nmsThreshold NMS阈值
- * @return 过滤后的检测框索引
+ * @param mode 类别处理方式
+ * @param workspace 复用的工作区
+ * @param indices 输出的保留框索引（按分数降序；PerClass模式下按类别分组，组内按分数降序）
  */
-std::vector<int> applyNMS(const std::vector<cv::Rect>& boxes, 
-                         const std::vector<float>& scores, 
-                         float scoreThreshold, 
-                         float nmsThreshold) {
-    std::vector<int> indices;
+void applyNMS(const std::vector<cv::Rect>& boxes, 
+              const std::vector<float>& scores, 
+              const std::vector<int>& classIds, 
+              float scoreThreshold, 
+              float nmsThreshold, 
+              NMSMode mode, 
+              NMSWorkspace& workspace, 
+              std::vector<int>& indices) {
+    indices.clear();
+    if (classIds.size() != boxes.size()) {
+        mode = NMSMode::ClassAgnostic;
+    }
     
-    // 首先过滤掉低于分数阈值的检测框
-    std::vector<int> candidateIndices;
+    // 过滤掉低于分数阈值的检测框，然后只排序一次
+    std::vector<int>& order = workspace.order;
+    order.clear();
     for (size_t i = 0; i < scores.size(); ++i) {
         if (scores[i] >= scoreThreshold) {
-            candidateIndices.push_back(static_cast<int>(i));
+            order.push_back(static_cast<int>(i));
         }
     }
+    if (mode == NMSMode::PerClass) {
+        // 按类别分组、组内按分数降序，每个框只需与本类别的区间比较
+        std::sort(order.begin(), order.end(), [&scores, &classIds](int a, int b) {
+            if (classIds[a] != classIds[b]) {
+                return classIds[a] < classIds[b];
+            }
+            return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+        });
+    } else {
+        std::sort(order.begin(), order.end(), [&scores](int a, int b) {
+            return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+        });
+    }
     
-    // 应用NMS
-    while (!candidateIndices.empty()) {
-        // 找到置信度最高的检测框
-        int bestIdx = 0;
-        float bestScore = scores[candidateIndices[bestIdx]];
-        for (size_t i = 1; i < candidateIndices.size(); ++i) {
-            if (scores[candidateIndices[i]] > bestScore) {
-                bestScore = scores[candidateIndices[i]];
-                bestIdx = static_cast<int>(i);
+    const size_t n = order.size();
+    if (n == 0) {
+        return;
+    }
+    
+    // ClassOffset模式下每个类别平移到互不重叠的区域
+    float classOffset = 0.0f;
+    if (mode == NMSMode::ClassOffset) {
+        int maxCoord = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const cv::Rect& box = boxes[order[k]];
+            maxCoord = std::max(maxCoord, std::max(box.x + box.width, box.y + box.height));
+        }
+        classOffset = static_cast<float>(maxCoord + 1);
+    }
+    
+    // 按排序后的顺序构建SoA坐标
+    workspace.x1.resize(n);
+    workspace.y1.resize(n);
+    workspace.x2.resize(n);
+    workspace.y2.resize(n);
+    workspace.area.resize(n);
+    workspace.classIds.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const int idx = order[k];
+        const cv::Rect& box = boxes[idx];
+        const int classId = mode == NMSMode::ClassAgnostic ? 0 : classIds[idx];
+        const float offset = classOffset * classId;
+        workspace.x1[k] = box.x + offset;
+        workspace.y1[k] = box.y + offset;
+        workspace.x2[k] = box.x + box.width + offset;
+        workspace.y2[k] = box.y + box.height + offset;
+        workspace.area[k] = static_cast<float>(box.area());
+        workspace.classIds[k] = classId;
+    }
+    
+    workspace.suppressed.assign((n + 63) / 64 + 1, 0);
+    const uint64_t* bits = workspace.suppressed.data();
+    
+    size_t groupEnd = n;
+    for (size_t i = 0; i < n; ++i) {
+        if (mode == NMSMode::PerClass && (i == 0 || workspace.classIds[i] != workspace.classIds[i - 1])) {
+            // 进入新的类别分组，找到分组末尾
+            groupEnd = i + 1;
+            while (groupEnd < n && workspace.classIds[groupEnd] == workspace.classIds[i]) {
+                ++groupEnd;
             }
         }
         
-        // 将最佳检测框添加到结果中
-        int bestCandidateIdx = candidateIndices[bestIdx];
-        indices.push_back(bestCandidateIdx);
-        
-        // 从候选列表中移除最佳检测框
-        candidateIndices.erase(candidateIndices.begin() + bestIdx);
-        
-        // 计算与剩余检测框的IoU，并移除重叠度高的检测框
-        std::vector<int> newCandidateIndices;
-        for (int idx : candidateIndices) {
-            float iou = calculateIoU(boxes[bestCandidateIdx], boxes[idx]);
-            if (iou < nmsThreshold) {
-                newCandidateIndices.push_back(idx);
-            }
+        if (bits[i >> 6] & (uint64_t(1) << (i & 63))) {
+            continue;
         }
-        candidateIndices = newCandidateIndices;
+        indices.push_back(order[i]);
+        suppressOverlaps(workspace, i, i + 1, groupEnd, nmsThreshold);
     }
-    
-    return indices;
 }
 
 /**
@@ -93,6 +217,41 @@ float calculateIoU(const cv::Rect& box1, const cv::Rect& box2) {
     return intersectionArea / unionArea;
 }
 
+bool isProbabilityDistribution(const float* values, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] < 0.0f || values[i] > 1.0f) {
+            return false;
+        }
+        sum += values[i];
+    }
+    return std::fabs(sum - 1.0f) < 1e-3f;
+}
+
+void toProbabilities(float* values, size_t count) {
+    if (count == 0 || isProbabilityDistribution(values, count)) {
+        return;
+    }
+    // 减去最大值后再取指数，避免溢出
+    const float maxLogit = *std::max_element(values, values + count);
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::exp(values[i] - maxLogit);
+        sum += values[i];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        values[i] /= sum;
+    }
+}
+
+cv::Rect2f expandBox(const cv::Rect& box, float margin, const cv::Size& imageSize) {
+    const float marginX = box.width * margin;
+    const float marginY = box.height * margin;
+    const cv::Rect2f imageRect(0.0f, 0.0f, static_cast<float>(imageSize.width), static_cast<float>(imageSize.height));
+    return cv::Rect2f(box.x - marginX, box.y - marginY, box.width + marginX * 2.0f, box.height + marginY * 2.0f) &
+           imageRect;
+}
+
 /**
  * @brief 对YOLO模型的输出进行后处理，获取检测框和类别
  * @param outputs 模型输出
@@ -112,78 +271,270 @@ void processYOLOOutput(const cv::Mat& outputs,
                       std::vector<cv::Rect>& boxes, 
                       std::vector<float>& confidences, 
                       std::vector<int>& classIds) {
-    // YOLO输出格式：每行包含 [center_x, center_y, width, height, confidence, class1_score, class2_score, ...]
-    const int dimensions = outputs.size[1];
-    const int numBoxes = outputs.size[0];
+    std::vector<cv::Rect> candidateBoxes;
+    std::vector<float> candidateConfidences;
+    std::vector<int> candidateClassIds;
     
-    boxes.clear();
-    confidences.clear();
-    classIds.clear();
+    decodeYOLOCandidates(outputs, confidenceThreshold, imageWidth, imageHeight,
+                         candidateBoxes, candidateConfidences, candidateClassIds);
     
-    for (int i = 0; i < numBoxes; ++i) {
-        const float* data = outputs.ptr<float>(i);
-        
-        // 提取边界框坐标
-        float centerX = data[0] * imageWidth;
-        float centerY = data[1] * imageHeight;
-        float width = data[2] * imageWidth;
-        float height = data[3] * imageHeight;
-        
-        // 转换为左上角坐标和宽高
-        int x = static_cast<int>(centerX - width / 2);
-        int y = static_cast<int>(centerY - height / 2);
-        
-        // 确保边界框在图像范围内
-        x = std::max(0, x);
-        y = std::max(0, y);
-        width = std::min(static_cast<float>(imageWidth - x), width);
-        height = std::min(static_cast<float>(imageHeight - y), height);
-        
-        // 创建检测框
-        cv::Rect box(x, y, static_cast<int>(width), static_cast<int>(height));
-        
-        // 提取置信度
-        float confidence = data[4];
-        
-        // 如果置信度高于阈值，继续处理
-        if (confidence >= confidenceThreshold) {
-            // 查找最高得分的类别
-            float highestScore = 0.0f;
-            int classId = -1;
-            
-            for (int j = 5; j < dimensions; ++j) {
-                if (data[j] > highestScore) {
-                    highestScore = data[j];
-                    classId = j - 5;
-                }
-            }
-            
-            // 如果类别得分高于阈值，添加到结果
-            if (highestScore >= confidenceThreshold) {
-                boxes.push_back(box);
-                confidences.push_back(confidence * highestScore);
-                classIds.push_back(classId);
-            }
-        }
-    }
+    // 应用NMS
+    selectNMSResults(candidateBoxes, candidateConfidences, candidateClassIds,
+                     confidenceThreshold, nmsThreshold, boxes, confidences, classIds);
+}
+
+/**
+ * @brief 对INT8量化模型的YOLO输出进行后处理
+ * @param outputs 模型输出（CV_8U/CV_8S，或float）
+ * @param quantization 输出张量的量化参数
+ * @param confidenceThreshold 置信度阈值
+ * @param nmsThreshold NMS阈值
+ * @param imageWidth 图像宽度
+ * @param imageHeight 图像高度
+ * @param boxes 输出的检测框
+ * @param confidences 输出的置信度
+ * @param classIds 输出的类别ID
+ */
+void processYOLOOutput(const cv::Mat& outputs, 
+                      const QuantizationParams& quantization,
+                      float confidenceThreshold, 
+                      float nmsThreshold, 
+                      int imageWidth, 
+                      int imageHeight, 
+                      std::vector<cv::Rect>& boxes, 
+                      std::vector<float>& confidences, 
+                      std::vector<int>& classIds) {
+    std::vector<cv::Rect> candidateBoxes;
+    std::vector<float> candidateConfidences;
+    std::vector<int> candidateClassIds;
+    
+    YOLODecodeWorkspace workspace;
+    decodeYOLOOutput(outputs, YOLOOutputLayout::RowsWithObjectness, quantization, confidenceThreshold,
+                     YOLOBoxMapping::normalized(imageWidth, imageHeight), imageWidth, imageHeight,
+                     workspace, candidateBoxes, candidateConfidences, candidateClassIds);
     
     // 应用NMS
-    std::vector<int> indices = applyNMS(boxes, confidences, confidenceThreshold, nmsThreshold);
+    selectNMSResults(candidateBoxes, candidateConfidences, candidateClassIds,
+                     confidenceThreshold, nmsThreshold, boxes, confidences, classIds);
+}
+
+/**
+ * @brief 解码一个 N×D 的YOLO输出，将通过阈值的候选框追加到输出列表
+ * @param outputs 模型输出
+ * @param confidenceThreshold 置信度阈值
+ * @param imageWidth 图像宽度
+ * @param imageHeight 图像高度
+ * @param boxes 追加的检测框
+ * @param confidences 追加的置信度
+ * @param classIds 追加的类别ID
+ */
+void decodeYOLOCandidates(const cv::Mat& outputs, 
+                          float confidenceThreshold, 
+                          int imageWidth, 
+                          int imageHeight, 
+                          std::vector<cv::Rect>& boxes, 
+                          std::vector<float>& confidences, 
+                          std::vector<int>& classIds) {
+    // YOLO输出格式：每行包含 [center_x, center_y, width, height, confidence, class1_score, class2_score, ...]
+    YOLODecodeWorkspace workspace;
+    decodeYOLORows(outputs, confidenceThreshold, YOLOBoxMapping::normalized(imageWidth, imageHeight),
+                   imageWidth, imageHeight, workspace, boxes, confidences, classIds);
+}
+
+/**
+ * @brief 解码经过信箱缩放预处理的YOLO输出，并映射回原图坐标
+ * @param outputs 模型输出
+ * @param confidenceThreshold 置信度阈值
+ * @param letterbox 预处理时使用的信箱缩放参数
+ * @param imageWidth 原图宽度
+ * @param imageHeight 原图高度
+ * @param boxes 追加的检测框
+ * @param confidences 追加的置信度
+ * @param classIds 追加的类别ID
+ */
+void decodeYOLOCandidates(const cv::Mat& outputs, 
+                          float confidenceThreshold, 
+                          const LetterboxInfo& letterbox, 
+                          int imageWidth, 
+                          int imageHeight, 
+                          std::vector<cv::Rect>& boxes, 
+                          std::vector<float>& confidences, 
+                          std::vector<int>& classIds) {
+    YOLODecodeWorkspace workspace;
+    decodeYOLORows(outputs, confidenceThreshold, YOLOBoxMapping::fromLetterbox(letterbox),
+                   imageWidth, imageHeight, workspace, boxes, confidences, classIds);
+}
+
+/**
+ * @brief 对候选框执行NMS，并把保留下来的结果写入输出列表
+ * @param boxes 候选检测框
+ * @param confidences 候选置信度
+ * @param classIds 候选类别ID
+ * @param scoreThreshold 分数阈值
+ * @param nmsThreshold NMS阈值
+ * @param keptBoxes 保留的检测框
+ * @param keptConfidences 保留的置信度
+ * @param keptClassIds 保留的类别ID
+ */
+void selectNMSResults(const std::vector<cv::Rect>& boxes, 
+                      const std::vector<float>& confidences, 
+                      const std::vector<int>& classIds, 
+                      float scoreThreshold, 
+                      float nmsThreshold, 
+                      std::vector<cv::Rect>& keptBoxes, 
+                      std::vector<float>& keptConfidences, 
+                      std::vector<int>& keptClassIds) {
+    NMSWorkspace workspace;
+    std::vector<int> indices;
+    selectNMSResults(boxes, confidences, classIds, scoreThreshold, nmsThreshold,
+                     workspace, indices, keptBoxes, keptConfidences, keptClassIds);
+}
+
+/**
+ * @brief 使用复用工作区对候选框执行按类别的NMS，并把保留下来的结果写入输出列表
+ * @param boxes 候选检测框
+ * @param confidences 候选置信度
+ * @param classIds 候选类别ID
+ * @param scoreThreshold 分数阈值
+ * @param nmsThreshold NMS阈值
+ * @param workspace 复用的NMS工作区
+ * @param indices 复用的索引缓冲区
+ * @param keptBoxes 保留的检测框
+ * @param keptConfidences 保留的置信度
+ * @param keptClassIds 保留的类别ID
+ */
+void selectNMSResults(const std::vector<cv::Rect>& boxes, 
+                      const std::vector<float>& confidences, 
+                      const std::vector<int>& classIds, 
+                      float scoreThreshold, 
+                      float nmsThreshold, 
+                      NMSWorkspace& workspace, 
+                      std::vector<int>& indices, 
+                      std::vector<cv::Rect>& keptBoxes, 
+                      std::vector<float>& keptConfidences, 
+                      std::vector<int>& keptClassIds) {
+    // 不同类别的框互不抑制（例如人物站在雕像前）
+    applyNMS(boxes, confidences, classIds, scoreThreshold, nmsThreshold,
+             NMSMode::PerClass, workspace, indices);
     
     // 根据NMS结果过滤检测框
-    std::vector<cv::Rect> filteredBoxes;
-    std::vector<float> filteredConfidences;
-    std::vector<int> filteredClassIds;
-    
+    keptBoxes.clear();
+    keptConfidences.clear();
+    keptClassIds.clear();
     for (int idx : indices) {
-        filteredBoxes.push_back(boxes[idx]);
-        filteredConfidences.push_back(confidences[idx]);
-        filteredClassIds.push_back(classIds[idx]);
+        keptBoxes.push_back(boxes[idx]);
+        keptConfidences.push_back(confidences[idx]);
+        keptClassIds.push_back(classIds[idx]);
     }
+}
+
+/**
+ * @brief 把区域划分为相互重叠的正方形切片
+ * @param region 需要覆盖的区域
+ * @param imageSize 图像尺寸
+ * @param tileSize 切片边长
+ * @param overlap 相邻切片的重叠比例
+ * @param tiles 追加的切片矩形
+ */
+void computeTiles(const cv::Rect& region, 
+                  const cv::Size& imageSize, 
+                  int tileSize, 
+                  float overlap, 
+                  std::vector<cv::Rect>& tiles) {
+    cv::Rect area = region & cv::Rect(0, 0, imageSize.width, imageSize.height);
+    if (area.width <= 0 || area.height <= 0 || tileSize <= 0) {
+        return;
+    }
+    
+    overlap = std::max(0.0f, std::min(overlap, 0.5f));
+    const int step = std::max(1, static_cast<int>(tileSize * (1.0f - overlap)));
+    
+    // 一个方向上的切片起点：均匀步进，最后一片与区域末端对齐
+    auto starts = [&](int begin, int length, int limit, std::vector<int>& out) {
+        out.clear();
+        if (length <= tileSize) {
+            // 区域比切片小：以区域为中心取一片，尽量不超出图像
+            int start = begin + length / 2 - tileSize / 2;
+            out.push_back(std::max(0, std::min(start, limit - tileSize)));
+            return;
+        }
+        for (int pos = begin; ; pos += step) {
+            if (pos + tileSize >= begin + length) {
+                out.push_back(begin + length - tileSize);
+                break;
+            }
+            out.push_back(pos);
+        }
+    };
     
-    boxes = filteredBoxes;
-    confidences = filteredConfidences;
-    classIds = filteredClassIds;
+    std::vector<int> xs;
+    std::vector<int> ys;
+    starts(area.x, area.width, imageSize.width, xs);
+    starts(area.y, area.height, imageSize.height, ys);
+    for (int y : ys) {
+        for (int x : xs) {
+            // 图像本身比切片小时切片会被裁剪，预处理时按信箱缩放补齐
+            cv::Rect tile(x, y, tileSize, tileSize);
+            tiles.push_back(tile & cv::Rect(0, 0, imageSize.width, imageSize.height));
+        }
+    }
+}
+
+/**
+ * @brief 合并来自多个切片的检测结果（按类别NMS + 截断框抑制）
+ * @param boxes 所有切片的检测框
+ * @param confidences 置信度
+ * @param classIds 类别ID
+ * @param scoreThreshold 分数阈值
+ * @param nmsThreshold NMS阈值
+ * @param containmentThreshold 截断框的包含比例阈值
+ * @param workspace 复用的NMS工作区
+ * @param indices 复用的索引缓冲区
+ * @param keptBoxes 保留的检测框
+ * @param keptConfidences 保留的置信度
+ * @param keptClassIds 保留的类别ID
+ */
+void mergeTiledDetections(const std::vector<cv::Rect>& boxes, 
+                          const std::vector<float>& confidences, 
+                          const std::vector<int>& classIds, 
+                          float scoreThreshold, 
+                          float nmsThreshold, 
+                          float containmentThreshold, 
+                          NMSWorkspace& workspace, 
+                          std::vector<int>& indices, 
+                          std::vector<cv::Rect>& keptBoxes, 
+                          std::vector<float>& keptConfidences, 
+                          std::vector<int>& keptClassIds) {
+    // 第一步：跨切片的按类别NMS（结果按类别分组，组内按分数降序）
+    applyNMS(boxes, confidences, classIds, scoreThreshold, nmsThreshold,
+             NMSMode::PerClass, workspace, indices);
+    
+    // 第二步：被切片边界截断的框通常落在相邻切片的完整框内，IoU不高但包含比例高。
+    // 保留下来的框数量很少，直接两两比较
+    keptBoxes.clear();
+    keptConfidences.clear();
+    keptClassIds.clear();
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const int idx = indices[i];
+        const cv::Rect& box = boxes[idx];
+        bool contained = false;
+        for (size_t k = 0; k < keptBoxes.size(); ++k) {
+            if (keptClassIds[k] != classIds[idx]) {
+                continue;
+            }
+            const int inter = (box & keptBoxes[k]).area();
+            const int smaller = std::min(box.area(), keptBoxes[k].area());
+            if (smaller > 0 && inter >= containmentThreshold * smaller) {
+                contained = true;
+                break;
+            }
+        }
+        if (!contained) {
+            keptBoxes.push_back(box);
+            keptConfidences.push_back(confidences[idx]);
+            keptClassIds.push_back(classIds[idx]);
+        }
+    }
 }
 
 /**
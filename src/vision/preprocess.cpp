@@ -0,0 +1,275 @@
+#include "vision/preprocess.h"
+#include <algorithm>
+#include <cmath>
+#include "utils/simd.h"
+
+namespace {
+
+// YOLO训练时使用的信箱填充灰度值
+const float kPadValue = 114.0f / 255.0f;
+
+// 按目标宽度重新计算水平插值查找表
+void prepareHorizontalTables(PreprocessWorkspace& ws, int srcWidth, int newWidth, float scale) {
+    if (ws.cachedSrcWidth == srcWidth && ws.cachedDstWidth == newWidth) {
+        return;
+    }
+
+    ws.xOffset0.resize(newWidth);
+    ws.xOffset1.resize(newWidth);
+    ws.xWeight.resize(newWidth);
+    ws.rowBuffer.resize(static_cast<size_t>(srcWidth) * 3 + 8);
+
+    const float invScale = 1.0f / scale;
+    for (int x = 0; x < newWidth; ++x) {
+        // 与cv::resize的INTER_LINEAR一致的像素中心对齐
+        float sx = (x + 0.5f) * invScale - 0.5f;
+        if (sx < 0.0f) {
+            sx = 0.0f;
+        }
+        int x0 = static_cast<int>(sx);
+        if (x0 > srcWidth - 1) {
+            x0 = srcWidth - 1;
+        }
+        int x1 = std::min(x0 + 1, srcWidth - 1);
+        ws.xOffset0[x] = x0 * 3;
+        ws.xOffset1[x] = x1 * 3;
+        ws.xWeight[x] = sx - x0;
+    }
+    ws.cachedSrcWidth = srcWidth;
+    ws.cachedDstWidth = newWidth;
+}
+
+// 垂直插值：row = (s0 * (1 - wy) + s1 * wy) / 255，两行源数据连续读取，便于向量化
+void blendRows(const uchar* s0, const uchar* s1, float wy, float* row, int count) {
+    const float w0 = (1.0f - wy) / 255.0f;
+    const float w1 = wy / 255.0f;
+    int i = 0;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+    const __m256 vw0 = _mm256_set1_ps(w0);
+    const __m256 vw1 = _mm256_set1_ps(w1);
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s0 + i))));
+        __m256 b = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s1 + i))));
+        _mm256_storeu_ps(row + i, _mm256_add_ps(_mm256_mul_ps(a, vw0), _mm256_mul_ps(b, vw1)));
+    }
+#elif defined(AICOMPANION_HAVE_SSE2)
+    const __m128 vw0 = _mm_set1_ps(w0);
+    const __m128 vw1 = _mm_set1_ps(w1);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i a16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s0 + i)), zero);
+        __m128i b16 = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s1 + i)), zero);
+        __m128 aLo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a16, zero));
+        __m128 aHi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a16, zero));
+        __m128 bLo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b16, zero));
+        __m128 bHi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(b16, zero));
+        _mm_storeu_ps(row + i, _mm_add_ps(_mm_mul_ps(aLo, vw0), _mm_mul_ps(bLo, vw1)));
+        _mm_storeu_ps(row + i + 4, _mm_add_ps(_mm_mul_ps(aHi, vw0), _mm_mul_ps(bHi, vw1)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        row[i] = s0[i] * w0 + s1[i] * w1;
+    }
+}
+
+// 水平插值并拆分通道：BGR交错的行缓冲区 → R、G、B三个平面
+void resampleRow(const PreprocessWorkspace& ws, int newWidth, float* planeR, float* planeG, float* planeB) {
+    const float* row = ws.rowBuffer.data();
+    const int* off0 = ws.xOffset0.data();
+    const int* off1 = ws.xOffset1.data();
+    const float* wx = ws.xWeight.data();
+    int x = 0;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+    for (; x + 8 <= newWidth; x += 8) {
+        __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(off0 + x));
+        __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(off1 + x));
+        __m256 w = _mm256_loadu_ps(wx + x);
+
+        // 通道0为B
+        __m256 a = _mm256_i32gather_ps(row, i0, 4);
+        __m256 b = _mm256_i32gather_ps(row, i1, 4);
+        _mm256_storeu_ps(planeB + x, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), w)));
+
+        // 通道1为G
+        a = _mm256_i32gather_ps(row + 1, i0, 4);
+        b = _mm256_i32gather_ps(row + 1, i1, 4);
+        _mm256_storeu_ps(planeG + x, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), w)));
+
+        // 通道2为R
+        a = _mm256_i32gather_ps(row + 2, i0, 4);
+        b = _mm256_i32gather_ps(row + 2, i1, 4);
+        _mm256_storeu_ps(planeR + x, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), w)));
+    }
+#endif
+
+    for (; x < newWidth; ++x) {
+        const float* p0 = row + off0[x];
+        const float* p1 = row + off1[x];
+        const float w = wx[x];
+        planeB[x] = p0[0] + (p1[0] - p0[0]) * w;
+        planeG[x] = p0[1] + (p1[1] - p0[1]) * w;
+        planeR[x] = p0[2] + (p1[2] - p0[2]) * w;
+    }
+}
+
+// 保持宽高比缩放，居中放置
+LetterboxInfo computeLetterbox(int srcWidth, int srcHeight, int dstWidth, int dstHeight,
+                               int& newWidth, int& newHeight) {
+    LetterboxInfo info;
+    info.scale = std::min(static_cast<float>(dstWidth) / srcWidth,
+                          static_cast<float>(dstHeight) / srcHeight);
+    newWidth = std::min(dstWidth, static_cast<int>(std::round(srcWidth * info.scale)));
+    newHeight = std::min(dstHeight, static_cast<int>(std::round(srcHeight * info.scale)));
+    info.padX = (dstWidth - newWidth) / 2;
+    info.padY = (dstHeight - newHeight) / 2;
+    info.inputWidth = dstWidth;
+    info.inputHeight = dstHeight;
+    return info;
+}
+
+// 把[0,1]的一行数值量化为uint8/int8：q = round(v / scale + zeroPoint)，饱和到取值范围
+void quantizeRow(const float* src, uint8_t* dst, int count, const QuantizationParams& quant) {
+    const float invScale = 1.0f / quant.scale;
+    const float zeroPoint = static_cast<float>(quant.zeroPoint);
+    int i = 0;
+
+#if defined(AICOMPANION_HAVE_SSE2)
+    // 转换为int32后两次饱和打包，一次处理8个
+    const __m128 vinv = _mm_set1_ps(invScale);
+    const __m128 vzero = _mm_set1_ps(zeroPoint);
+    for (; i + 8 <= count; i += 8) {
+        __m128i lo = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), vinv), vzero));
+        __m128i hi = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), vinv), vzero));
+        __m128i packed16 = _mm_packs_epi32(lo, hi);
+        __m128i packed8 = quant.isSigned ? _mm_packs_epi16(packed16, packed16)
+                                         : _mm_packus_epi16(packed16, packed16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), packed8);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        dst[i] = static_cast<uint8_t>(quant.quantize(src[i]));
+    }
+}
+
+} // namespace
+
+LetterboxInfo letterboxToTensor(const cv::Mat& bgr,
+                                float* dst,
+                                int dstWidth,
+                                int dstHeight,
+                                PreprocessWorkspace& workspace) {
+    const int srcWidth = bgr.cols;
+    const int srcHeight = bgr.rows;
+
+    int newWidth = 0;
+    int newHeight = 0;
+    LetterboxInfo info = computeLetterbox(srcWidth, srcHeight, dstWidth, dstHeight, newWidth, newHeight);
+
+    prepareHorizontalTables(workspace, srcWidth, newWidth, info.scale);
+
+    const size_t planeSize = static_cast<size_t>(dstWidth) * dstHeight;
+    float* planeR = dst;
+    float* planeG = dst + planeSize;
+    float* planeB = dst + planeSize * 2;
+
+    const float invScale = 1.0f / info.scale;
+    for (int y = 0; y < dstHeight; ++y) {
+        float* rowR = planeR + static_cast<size_t>(y) * dstWidth;
+        float* rowG = planeG + static_cast<size_t>(y) * dstWidth;
+        float* rowB = planeB + static_cast<size_t>(y) * dstWidth;
+
+        const int contentY = y - info.padY;
+        if (contentY < 0 || contentY >= newHeight) {
+            // 上下填充行
+            std::fill(rowR, rowR + dstWidth, kPadValue);
+            std::fill(rowG, rowG + dstWidth, kPadValue);
+            std::fill(rowB, rowB + dstWidth, kPadValue);
+            continue;
+        }
+
+        // 左右填充列
+        const int rightPad = dstWidth - info.padX - newWidth;
+        std::fill(rowR, rowR + info.padX, kPadValue);
+        std::fill(rowG, rowG + info.padX, kPadValue);
+        std::fill(rowB, rowB + info.padX, kPadValue);
+        std::fill(rowR + info.padX + newWidth, rowR + info.padX + newWidth + rightPad, kPadValue);
+        std::fill(rowG + info.padX + newWidth, rowG + info.padX + newWidth + rightPad, kPadValue);
+        std::fill(rowB + info.padX + newWidth, rowB + info.padX + newWidth + rightPad, kPadValue);
+
+        // 垂直插值 + 归一化
+        float sy = (contentY + 0.5f) * invScale - 0.5f;
+        if (sy < 0.0f) {
+            sy = 0.0f;
+        }
+        int y0 = std::min(static_cast<int>(sy), srcHeight - 1);
+        int y1 = std::min(y0 + 1, srcHeight - 1);
+        blendRows(bgr.ptr<uchar>(y0), bgr.ptr<uchar>(y1), sy - y0,
+                  workspace.rowBuffer.data(), srcWidth * 3);
+
+        // 水平插值 + BGR→RGB + 写入CHW平面
+        resampleRow(workspace, newWidth, rowR + info.padX, rowG + info.padX, rowB + info.padX);
+    }
+
+    return info;
+}
+
+LetterboxInfo letterboxToTensorQuantized(const cv::Mat& bgr,
+                                         uint8_t* dst,
+                                         int dstWidth,
+                                         int dstHeight,
+                                         const QuantizationParams& quantization,
+                                         PreprocessWorkspace& workspace) {
+    const int srcWidth = bgr.cols;
+    const int srcHeight = bgr.rows;
+    int newWidth = 0;
+    int newHeight = 0;
+    LetterboxInfo info = computeLetterbox(srcWidth, srcHeight, dstWidth, dstHeight, newWidth, newHeight);
+
+    prepareHorizontalTables(workspace, srcWidth, newWidth, info.scale);
+    workspace.planeRows.resize(static_cast<size_t>(newWidth) * 3);
+    float* tmpR = workspace.planeRows.data();
+    float* tmpG = tmpR + newWidth;
+    float* tmpB = tmpG + newWidth;
+
+    const uint8_t pad = static_cast<uint8_t>(quantization.quantize(kPadValue));
+    const size_t planeSize = static_cast<size_t>(dstWidth) * dstHeight;
+    const float invScale = 1.0f / info.scale;
+    for (int y = 0; y < dstHeight; ++y) {
+        uint8_t* rows[3] = {dst + static_cast<size_t>(y) * dstWidth,
+                            dst + planeSize + static_cast<size_t>(y) * dstWidth,
+                            dst + planeSize * 2 + static_cast<size_t>(y) * dstWidth};
+
+        const int contentY = y - info.padY;
+        if (contentY < 0 || contentY >= newHeight) {
+            for (int c = 0; c < 3; ++c) {
+                std::fill(rows[c], rows[c] + dstWidth, pad);
+            }
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) {
+            std::fill(rows[c], rows[c] + info.padX, pad);
+            std::fill(rows[c] + info.padX + newWidth, rows[c] + dstWidth, pad);
+        }
+
+        float sy = (contentY + 0.5f) * invScale - 0.5f;
+        if (sy < 0.0f) {
+            sy = 0.0f;
+        }
+        int y0 = std::min(static_cast<int>(sy), srcHeight - 1);
+        int y1 = std::min(y0 + 1, srcHeight - 1);
+        blendRows(bgr.ptr<uchar>(y0), bgr.ptr<uchar>(y1), sy - y0,
+                  workspace.rowBuffer.data(), srcWidth * 3);
+        resampleRow(workspace, newWidth, tmpR, tmpG, tmpB);
+
+        // 插值结果按输入张量的量化参数写入CHW平面
+        quantizeRow(tmpR, rows[0] + info.padX, newWidth, quantization);
+        quantizeRow(tmpG, rows[1] + info.padX, newWidth, quantization);
+        quantizeRow(tmpB, rows[2] + info.padX, newWidth, quantization);
+    }
+
+    return info;
+}
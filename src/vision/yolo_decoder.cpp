@@ -0,0 +1,466 @@
+#include "vision/yolo_decoder.h"
+#include <algorithm>
+#include "utils/simd.h"
+
+namespace {
+
+// 行格式中目标置信度所在列和第一个类别得分所在列
+const int kObjectnessColumn = 4;
+const int kFirstClassColumn = 5;
+
+// 第一遍：只比较目标置信度，记录通过的行号，返回通过的行数
+size_t collectSurvivors(const float* base, int numRows, int stride, float threshold,
+                        std::vector<int>& survivors) {
+    if (survivors.size() < static_cast<size_t>(numRows)) {
+        survivors.resize(numRows);
+    }
+    int* out = survivors.data();
+    const float* objectness = base + kObjectnessColumn;
+    size_t count = 0;
+    int i = 0;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+    // 按行跨度gather 8行的目标置信度，一次比较
+    const __m256i rowOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                  _mm256_set1_epi32(stride));
+    const __m256 thr = _mm256_set1_ps(threshold);
+    for (; i + 8 <= numRows; i += 8) {
+        __m256 obj = _mm256_i32gather_ps(objectness + static_cast<size_t>(i) * stride, rowOffsets, 4);
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(obj, thr, _CMP_GE_OQ));
+        if (mask == 0) {
+            continue;
+        }
+        for (int b = 0; b < 8; ++b) {
+            if (mask & (1 << b)) {
+                out[count++] = i + b;
+            }
+        }
+    }
+#endif
+
+    // 无分支写入：先写行号，再按比较结果决定是否前进
+    for (; i < numRows; ++i) {
+        out[count] = i;
+        count += objectness[static_cast<size_t>(i) * stride] >= threshold ? 1 : 0;
+    }
+    return count;
+}
+
+// 第二遍：类别得分argmax，返回类别ID（所有得分都不大于0时返回-1）
+int argmaxScores(const float* scores, int count, float& highestScore) {
+    float best = 0.0f;
+    int j = 0;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+    if (count >= 8) {
+        __m256 vmax = _mm256_loadu_ps(scores);
+        for (j = 8; j + 8 <= count; j += 8) {
+            vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(scores + j));
+        }
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        best = std::max(best, _mm_cvtss_f32(m));
+    }
+#elif defined(AICOMPANION_HAVE_SSE2)
+    if (count >= 4) {
+        __m128 vmax = _mm_loadu_ps(scores);
+        for (j = 4; j + 4 <= count; j += 4) {
+            vmax = _mm_max_ps(vmax, _mm_loadu_ps(scores + j));
+        }
+        __m128 m = _mm_max_ps(vmax, _mm_movehl_ps(vmax, vmax));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        best = std::max(best, _mm_cvtss_f32(m));
+    }
+#endif
+
+    for (; j < count; ++j) {
+        best = std::max(best, scores[j]);
+    }
+
+    highestScore = best;
+    if (best <= 0.0f) {
+        return -1;
+    }
+
+    // 最大值确定后再找第一次出现的位置，与逐个比较的结果一致
+    int k = 0;
+#if defined(AICOMPANION_HAVE_AVX2)
+    const __m256 target = _mm256_set1_ps(best);
+    for (; k + 8 <= count; k += 8) {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(scores + k), target, _CMP_EQ_OQ));
+        if (mask) {
+            for (int b = 0; b < 8; ++b) {
+                if (mask & (1 << b)) {
+                    return k + b;
+                }
+            }
+        }
+    }
+#endif
+    for (; k < count; ++k) {
+        if (scores[k] == best) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+// 把中心点格式的框映射回原图并裁剪到图像范围内，框为空时返回false
+bool mapBox(float cx, float cy, float w, float h, const YOLOBoxMapping& mapping,
+            int imageWidth, int imageHeight, cv::Rect& box) {
+    const float halfW = w * 0.5f;
+    const float halfH = h * 0.5f;
+    const float left = (cx - halfW) * mapping.scaleX + mapping.offsetX;
+    const float top = (cy - halfH) * mapping.scaleY + mapping.offsetY;
+    const float right = (cx + halfW) * mapping.scaleX + mapping.offsetX;
+    const float bottom = (cy + halfH) * mapping.scaleY + mapping.offsetY;
+
+    int x = std::max(0, static_cast<int>(left));
+    int y = std::max(0, static_cast<int>(top));
+    int x2 = std::min(imageWidth, static_cast<int>(right));
+    int y2 = std::min(imageHeight, static_cast<int>(bottom));
+    if (x2 <= x || y2 <= y) {
+        return false;
+    }
+    box = cv::Rect(x, y, x2 - x, y2 - y);
+    return true;
+}
+
+// 用一个类别通道更新每个候选框的最高得分和类别（严格大于才更新，平局保留较小的类别）
+void updateBestScores(const float* scores, int count, int classId, float* best, int* bestClass) {
+    int i = 0;
+
+#if defined(AICOMPANION_HAVE_AVX2)
+    const __m256i vclass = _mm256_set1_epi32(classId);
+    for (; i + 8 <= count; i += 8) {
+        __m256 s = _mm256_loadu_ps(scores + i);
+        __m256 b = _mm256_loadu_ps(best + i);
+        __m256 gt = _mm256_cmp_ps(s, b, _CMP_GT_OQ);
+        _mm256_storeu_ps(best + i, _mm256_blendv_ps(b, s, gt));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bestClass + i));
+        c = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(c), _mm256_castsi256_ps(vclass), gt));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bestClass + i), c);
+    }
+#elif defined(AICOMPANION_HAVE_SSE2)
+    const __m128i vclass = _mm_set1_epi32(classId);
+    for (; i + 4 <= count; i += 4) {
+        __m128 s = _mm_loadu_ps(scores + i);
+        __m128 b = _mm_loadu_ps(best + i);
+        __m128 gt = _mm_cmpgt_ps(s, b);
+        _mm_storeu_ps(best + i, _mm_or_ps(_mm_and_ps(gt, s), _mm_andnot_ps(gt, b)));
+        __m128i mask = _mm_castps_si128(gt);
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bestClass + i));
+        c = _mm_or_si128(_mm_and_si128(mask, vclass), _mm_andnot_si128(mask, c));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bestClass + i), c);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (scores[i] > best[i]) {
+            best[i] = scores[i];
+            bestClass[i] = classId;
+        }
+    }
+}
+
+// 按量化参数重建反量化查找表（参数不变时复用）
+const float* prepareLookup(YOLODecodeWorkspace& ws, const QuantizationParams& quant) {
+    if (ws.lookup.size() != 256 || ws.lookupParams.scale != quant.scale ||
+        ws.lookupParams.zeroPoint != quant.zeroPoint || ws.lookupParams.isSigned != quant.isSigned) {
+        ws.lookup.resize(256);
+        for (int b = 0; b < 256; ++b) {
+            const int q = quant.isSigned ? static_cast<int>(static_cast<int8_t>(b)) : b;
+            ws.lookup[b] = quant.dequantize(q);
+        }
+        ws.lookupParams = quant;
+    }
+    return ws.lookup.data();
+}
+
+void dequantizeSpan(const uint8_t* src, int count, const float* lookup, float* dst) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = lookup[src[i]];
+    }
+}
+
+} // namespace
+
+YOLOOutputLayout detectYOLOLayout(const std::vector<int>& shape) {
+    // 去掉前导的批次维度
+    size_t first = 0;
+    while (shape.size() - first > 2 && shape[first] == 1) {
+        ++first;
+    }
+    if (shape.size() - first == 2 && shape[first] < shape[first + 1]) {
+        return YOLOOutputLayout::ChannelsFirst;
+    }
+    return YOLOOutputLayout::RowsWithObjectness;
+}
+
+size_t decodeYOLORows(const cv::Mat& rows,
+                      float confidenceThreshold,
+                      const YOLOBoxMapping& mapping,
+                      int imageWidth,
+                      int imageHeight,
+                      YOLODecodeWorkspace& workspace,
+                      std::vector<cv::Rect>& boxes,
+                      std::vector<float>& confidences,
+                      std::vector<int>& classIds) {
+    if (rows.empty() || rows.dims != 2 || rows.cols <= kFirstClassColumn) {
+        return 0;
+    }
+
+    const int numRows = rows.rows;
+    const int dimensions = rows.cols;
+    const int stride = static_cast<int>(rows.step[0] / sizeof(float));
+    const float* base = rows.ptr<float>(0);
+
+    const size_t survivorCount = collectSurvivors(base, numRows, stride, confidenceThreshold,
+                                                  workspace.survivors);
+    if (survivorCount == 0) {
+        return 0;
+    }
+
+    // 一次性预留容量，后面的追加不会触发重新分配
+    boxes.reserve(boxes.size() + survivorCount);
+    confidences.reserve(confidences.size() + survivorCount);
+    classIds.reserve(classIds.size() + survivorCount);
+
+    const size_t before = boxes.size();
+    for (size_t s = 0; s < survivorCount; ++s) {
+        const float* data = base + static_cast<size_t>(workspace.survivors[s]) * stride;
+
+        float highestScore = 0.0f;
+        int classId = argmaxScores(data + kFirstClassColumn, dimensions - kFirstClassColumn, highestScore);
+        if (classId < 0 || highestScore < confidenceThreshold) {
+            continue;
+        }
+
+        // 模型输出坐标 → 原图坐标
+        cv::Rect box;
+        if (!mapBox(data[0], data[1], data[2], data[3], mapping, imageWidth, imageHeight, box)) {
+            continue;
+        }
+
+        boxes.push_back(box);
+        confidences.push_back(data[kObjectnessColumn] * highestScore);
+        classIds.push_back(classId);
+    }
+    return boxes.size() - before;
+}
+
+size_t decodeYOLOChannelsFirst(const cv::Mat& channels,
+                               float confidenceThreshold,
+                               const YOLOBoxMapping& mapping,
+                               int imageWidth,
+                               int imageHeight,
+                               YOLODecodeWorkspace& workspace,
+                               std::vector<cv::Rect>& boxes,
+                               std::vector<float>& confidences,
+                               std::vector<int>& classIds) {
+    // 通道 0-3 为 cx, cy, w, h，之后每个通道是一个类别的得分
+    const int kBoxChannels = 4;
+    if (channels.empty() || channels.dims != 2 || channels.rows <= kBoxChannels) {
+        return 0;
+    }
+
+    const int numClasses = channels.rows - kBoxChannels;
+    const int numBoxes = channels.cols;
+    const size_t stride = channels.step[0] / sizeof(float);
+    const float* base = channels.ptr<float>(0);
+
+    if (workspace.bestScores.size() < static_cast<size_t>(numBoxes)) {
+        workspace.bestScores.resize(numBoxes);
+        workspace.bestClasses.resize(numBoxes);
+    }
+    float* best = workspace.bestScores.data();
+    int* bestClass = workspace.bestClasses.data();
+    std::fill(best, best + numBoxes, 0.0f);
+    std::fill(bestClass, bestClass + numBoxes, -1);
+
+    // 按通道顺序扫描，每次读取的都是连续内存
+    for (int c = 0; c < numClasses; ++c) {
+        updateBestScores(base + (kBoxChannels + c) * stride, numBoxes, c, best, bestClass);
+    }
+
+    // 筛选超过阈值的候选框（无分支写入）
+    if (workspace.survivors.size() < static_cast<size_t>(numBoxes)) {
+        workspace.survivors.resize(numBoxes);
+    }
+    int* survivors = workspace.survivors.data();
+    size_t survivorCount = 0;
+    for (int i = 0; i < numBoxes; ++i) {
+        survivors[survivorCount] = i;
+        survivorCount += (bestClass[i] >= 0 && best[i] >= confidenceThreshold) ? 1 : 0;
+    }
+    if (survivorCount == 0) {
+        return 0;
+    }
+
+    boxes.reserve(boxes.size() + survivorCount);
+    confidences.reserve(confidences.size() + survivorCount);
+    classIds.reserve(classIds.size() + survivorCount);
+
+    const float* cx = base;
+    const float* cy = base + stride;
+    const float* w = base + stride * 2;
+    const float* h = base + stride * 3;
+    const size_t before = boxes.size();
+    for (size_t s = 0; s < survivorCount; ++s) {
+        const int i = survivors[s];
+        cv::Rect box;
+        if (!mapBox(cx[i], cy[i], w[i], h[i], mapping, imageWidth, imageHeight, box)) {
+            continue;
+        }
+        boxes.push_back(box);
+        confidences.push_back(best[i]);
+        classIds.push_back(bestClass[i]);
+    }
+    return boxes.size() - before;
+}
+
+size_t decodeYOLOOutput(const cv::Mat& output,
+                        YOLOOutputLayout layout,
+                        float confidenceThreshold,
+                        const YOLOBoxMapping& mapping,
+                        int imageWidth,
+                        int imageHeight,
+                        YOLODecodeWorkspace& workspace,
+                        std::vector<cv::Rect>& boxes,
+                        std::vector<float>& confidences,
+                        std::vector<int>& classIds) {
+    if (layout == YOLOOutputLayout::ChannelsFirst) {
+        return decodeYOLOChannelsFirst(output, confidenceThreshold, mapping, imageWidth, imageHeight,
+                                       workspace, boxes, confidences, classIds);
+    }
+    return decodeYOLORows(output, confidenceThreshold, mapping, imageWidth, imageHeight,
+                          workspace, boxes, confidences, classIds);
+}
+
+size_t decodeYOLOQuantized(const cv::Mat& output,
+                           YOLOOutputLayout layout,
+                           const QuantizationParams& quantization,
+                           float confidenceThreshold,
+                           const YOLOBoxMapping& mapping,
+                           int imageWidth,
+                           int imageHeight,
+                           YOLODecodeWorkspace& workspace,
+                           std::vector<cv::Rect>& boxes,
+                           std::vector<float>& confidences,
+                           std::vector<int>& classIds) {
+    if (output.empty() || output.dims != 2 || output.elemSize() != 1) {
+        return 0;
+    }
+    const float* lookup = prepareLookup(workspace, quantization);
+    const uint8_t* base = output.ptr<uint8_t>(0);
+    const size_t stride = output.step[0];
+    const size_t before = boxes.size();
+
+    if (layout == YOLOOutputLayout::ChannelsFirst) {
+        const int kBoxChannels = 4;
+        if (output.rows <= kBoxChannels) {
+            return 0;
+        }
+        const int numClasses = output.rows - kBoxChannels;
+        const int numBoxes = output.cols;
+        if (workspace.bestScores.size() < static_cast<size_t>(numBoxes)) {
+            workspace.bestScores.resize(numBoxes);
+            workspace.bestClasses.resize(numBoxes);
+        }
+        if (workspace.dequantized.size() < static_cast<size_t>(numBoxes)) {
+            workspace.dequantized.resize(numBoxes);
+        }
+        float* best = workspace.bestScores.data();
+        int* bestClass = workspace.bestClasses.data();
+        float* channel = workspace.dequantized.data();
+        std::fill(best, best + numBoxes, 0.0f);
+        std::fill(bestClass, bestClass + numBoxes, -1);
+
+        // 逐个类别通道反量化后沿用float路径的向量化更新
+        for (int c = 0; c < numClasses; ++c) {
+            dequantizeSpan(base + (kBoxChannels + c) * stride, numBoxes, lookup, channel);
+            updateBestScores(channel, numBoxes, c, best, bestClass);
+        }
+
+        for (int i = 0; i < numBoxes; ++i) {
+            if (bestClass[i] < 0 || best[i] < confidenceThreshold) {
+                continue;
+            }
+            cv::Rect box;
+            if (!mapBox(lookup[base[i]], lookup[base[stride + i]], lookup[base[stride * 2 + i]],
+                        lookup[base[stride * 3 + i]], mapping, imageWidth, imageHeight, box)) {
+                continue;
+            }
+            boxes.push_back(box);
+            confidences.push_back(best[i]);
+            classIds.push_back(bestClass[i]);
+        }
+        return boxes.size() - before;
+    }
+
+    const int numRows = output.rows;
+    const int dimensions = output.cols;
+    if (dimensions <= kFirstClassColumn) {
+        return 0;
+    }
+
+    // 第一遍：只查目标置信度一列（无分支写入）
+    if (workspace.survivors.size() < static_cast<size_t>(numRows)) {
+        workspace.survivors.resize(numRows);
+    }
+    int* survivors = workspace.survivors.data();
+    size_t survivorCount = 0;
+    for (int i = 0; i < numRows; ++i) {
+        survivors[survivorCount] = i;
+        survivorCount += lookup[base[static_cast<size_t>(i) * stride + kObjectnessColumn]] >= confidenceThreshold ? 1 : 0;
+    }
+    if (survivorCount == 0) {
+        return 0;
+    }
+
+    // 第二遍：通过的行整行反量化，复用float路径的argmax
+    if (workspace.dequantized.size() < static_cast<size_t>(dimensions)) {
+        workspace.dequantized.resize(dimensions);
+    }
+    float* row = workspace.dequantized.data();
+    boxes.reserve(boxes.size() + survivorCount);
+    confidences.reserve(confidences.size() + survivorCount);
+    classIds.reserve(classIds.size() + survivorCount);
+    for (size_t s = 0; s < survivorCount; ++s) {
+        dequantizeSpan(base + static_cast<size_t>(survivors[s]) * stride, dimensions, lookup, row);
+
+        float highestScore = 0.0f;
+        int classId = argmaxScores(row + kFirstClassColumn, dimensions - kFirstClassColumn, highestScore);
+        if (classId < 0 || highestScore < confidenceThreshold) {
+            continue;
+        }
+        cv::Rect box;
+        if (!mapBox(row[0], row[1], row[2], row[3], mapping, imageWidth, imageHeight, box)) {
+            continue;
+        }
+        boxes.push_back(box);
+        confidences.push_back(row[kObjectnessColumn] * highestScore);
+        classIds.push_back(classId);
+    }
+    return boxes.size() - before;
+}
+
+size_t decodeYOLOOutput(const cv::Mat& output,
+                        YOLOOutputLayout layout,
+                        const QuantizationParams& quantization,
+                        float confidenceThreshold,
+                        const YOLOBoxMapping& mapping,
+                        int imageWidth,
+                        int imageHeight,
+                        YOLODecodeWorkspace& workspace,
+                        std::vector<cv::Rect>& boxes,
+                        std::vector<float>& confidences,
+                        std::vector<int>& classIds) {
+    if (output.depth() == CV_8U || output.depth() == CV_8S) {
+        return decodeYOLOQuantized(output, layout, quantization, confidenceThreshold, mapping,
+                                   imageWidth, imageHeight, workspace, boxes, confidences, classIds);
+    }
+    return decodeYOLOOutput(output, layout, confidenceThreshold, mapping, imageWidth, imageHeight,
+                            workspace, boxes, confidences, classIds);
+}
@@ -0,0 +1,164 @@
+// 视觉流水线稳态堆分配检查
+//
+// 替换全局operator new，统计整个进程的堆分配次数：流水线先处理若干帧预热（槽位、输入/输出张量、
+// 各工作区在这期间达到稳定容量），之后再处理N帧，期间的分配次数必须为0。
+// 用法: vision_alloc_check [帧来源] [--warmup 帧数] [--frames 帧数] [--seconds 秒数]
+// 在仓库根目录运行时，models/yolov5s.onnx存在则检查完整的推理路径，否则检查模拟模式下的流水线。
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <opencv2/opencv.hpp>
+#include "vision/VisionProcessor.h"
+
+namespace {
+std::atomic<size_t> heapAllocations(0);
+
+void* countedAlloc(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size > 0 ? size : 1);
+}
+}
+
+void* operator new(std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+// 等待发布序号达到target，超时返回false
+bool waitForSequence(const VisionProcessor& processor, unsigned long target,
+                     std::chrono::steady_clock::time_point deadline) {
+    while (processor.getDetections().sequence() < target) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+}
+
+int main(int argc, char** argv) {
+    std::string source = "synthetic";
+    unsigned long warmupFrames = 100;
+    unsigned long checkedFrames = 300;
+    double maxSeconds = 120.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--warmup" && hasValue) {
+            warmupFrames = std::strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--frames" && hasValue) {
+            checkedFrames = std::strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--seconds" && hasValue) {
+            maxSeconds = std::atof(argv[++i]);
+        } else if (arg.compare(0, 2, "--") != 0) {
+            source = arg;
+        } else {
+            std::cerr << "用法: " << argv[0] << " [帧来源] [--warmup 帧数] [--frames 帧数] [--seconds 秒数]" << std::endl;
+            return 2;
+        }
+    }
+
+    // OpenCV的线程池每次并行调用都会new一个任务对象，这属于库的调度开销而不是缓冲区，检查时串行执行
+    cv::setNumThreads(1);
+
+    // 每一帧都经过预处理、推理和后处理：关闭场景门控（模拟摄像头的画面不变），每帧都运行检测器
+    VisionProcessor processor;
+    processor.setFrameSource(source, false);
+    SceneChangeGateConfig gate;
+    processor.setSceneChangeGate(false, gate.diffThreshold, gate.histogramThreshold, gate.maxStaleMs);
+    processor.setDetectionInterval(1);
+    if (!processor.initialize()) {
+        std::cerr << "视觉处理系统初始化失败" << std::endl;
+        return 2;
+    }
+    while (processor.isModelLoading()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::cout << (processor.isModelReady() ? "推理后端: " + processor.getInferenceBackendName()
+                                           : std::string("未加载模型，检查模拟模式下的流水线")) << std::endl;
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(maxSeconds));
+    processor.start();
+
+    if (!waitForSequence(processor, warmupFrames, deadline)) {
+        processor.stop();
+        std::cerr << "预热超时，流水线没有发布足够的结果" << std::endl;
+        return 2;
+    }
+    const unsigned long firstFrame = processor.getDetections().sequence();
+    const size_t poolBefore = processor.getBufferAllocationCount();
+    const size_t heapBefore = heapAllocations.load();
+
+    const bool finished = waitForSequence(processor, firstFrame + checkedFrames, deadline);
+
+    const size_t heapAfter = heapAllocations.load();
+    const size_t poolAfter = processor.getBufferAllocationCount();
+    const unsigned long lastFrame = processor.getDetections().sequence();
+    processor.stop();
+
+    if (!finished) {
+        std::cerr << "检查超时，只处理了 " << lastFrame - firstFrame << " 帧" << std::endl;
+        return 2;
+    }
+
+    const size_t heap = heapAfter - heapBefore;
+    std::cout << "预热 " << firstFrame << " 帧后处理 " << lastFrame - firstFrame << " 帧: 堆分配 " << heap
+              << " 次，缓冲池重新分配 " << poolAfter - poolBefore << " 次" << std::endl;
+    if (heap != 0 || poolAfter != poolBefore) {
+        std::cerr << "稳态下仍有堆分配" << std::endl;
+        return 1;
+    }
+    std::cout << "稳态下没有堆分配" << std::endl;
+    return 0;
+}
@@ -0,0 +1,172 @@
+// 级联检测与分块推理同时启用时的结果检查
+//
+// 筛选模型的输入尺寸与完整模型不同时，预处理阶段只准备筛选模型的输入；升级到完整模型的高分辨率帧
+// 走分块推理，整图步骤必须使用本帧补做的完整模型输入。这里每帧都升级（刷新间隔为1），
+// 比较“级联+分块”和“只分块”两次运行最后一帧的检测结果，两者应当一致。
+// 用法: vision_cascade_tiling_check [筛选模型] [--input 筛选输入尺寸] [--frames 帧目录] [--seconds 秒数]
+// 在仓库根目录运行；缺少models/yolov5s.onnx或筛选模型时跳过（返回77）。
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "vision/VisionProcessor.h"
+#include "utils/FileSystem.h"
+
+namespace {
+const int kSkipped = 77;
+
+bool fileExists(const std::string& path) {
+    std::ifstream file(path.c_str());
+    return file.good();
+}
+
+// 由仓库中的高分辨率图像生成几帧不同的画面（长边都超过模型输入的1.5倍）
+bool writeFrames(const std::string& directory) {
+    cv::Mat image = cv::imread("travellama.png", cv::IMREAD_COLOR);
+    if (image.empty() || !ensureDirectory(directory)) {
+        return false;
+    }
+    cv::Mat flipped;
+    cv::flip(image, flipped, 1);
+    cv::Mat enlarged;
+    cv::resize(image, enlarged, cv::Size(1920, image.rows * 1920 / image.cols));
+    return cv::imwrite(directory + "/frame_0.png", image) &&
+           cv::imwrite(directory + "/frame_1.png", flipped) &&
+           cv::imwrite(directory + "/frame_2.png", enlarged);
+}
+
+// 回放帧目录中的所有帧，返回最后一帧的模型检测结果（不含没有模型类别的文物识别结果）
+bool runPipeline(VisionProcessor& processor, const std::string& frames, double maxSeconds,
+                 std::vector<Detection>& detections) {
+    processor.setFrameSource(frames, false);
+    SceneChangeGateConfig gate;
+    processor.setSceneChangeGate(false, gate.diffThreshold, gate.histogramThreshold, gate.maxStaleMs);
+    processor.setDetectionInterval(1);
+    processor.setTiledInference(true, false, 0.2f);
+    if (!processor.initialize()) {
+        std::cerr << "视觉处理系统初始化失败" << std::endl;
+        return false;
+    }
+    while (processor.isModelLoading()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!processor.isModelReady()) {
+        std::cerr << "模型加载失败" << std::endl;
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(maxSeconds));
+    processor.start();
+    while (!processor.isFrameSourceFinished() || !processor.isPipelineIdle()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            processor.stop();
+            std::cerr << "回放超时" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    detections.clear();
+    DetectionView view = processor.getDetections();
+    for (const auto& detection : view) {
+        if (detection.classId >= 0) {
+            detections.push_back(detection);
+        }
+    }
+    processor.stop();
+    return true;
+}
+
+bool sameDetections(const std::vector<Detection>& a, const std::vector<Detection>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        const cv::Rect& boxA = a[i].box;
+        const cv::Rect& boxB = b[i].box;
+        if (a[i].classId != b[i].classId || std::abs(a[i].score - b[i].score) > 1e-3f ||
+            std::abs(boxA.x - boxB.x) > 1 || std::abs(boxA.y - boxB.y) > 1 ||
+            std::abs(boxA.width - boxB.width) > 1 || std::abs(boxA.height - boxB.height) > 1) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+int main(int argc, char** argv) {
+    std::string screeningModel = "models/yolov5n.onnx";
+    int screeningInput = 320;
+    std::string frames = "cascade_tiling_frames";
+    double maxSeconds = 300.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--input" && hasValue) {
+            screeningInput = std::atoi(argv[++i]);
+        } else if (arg == "--frames" && hasValue) {
+            frames = argv[++i];
+        } else if (arg == "--seconds" && hasValue) {
+            maxSeconds = std::atof(argv[++i]);
+        } else if (arg.compare(0, 2, "--") != 0) {
+            screeningModel = arg;
+        } else {
+            std::cerr << "用法: " << argv[0] << " [筛选模型] [--input 筛选输入尺寸] [--frames 帧目录] [--seconds 秒数]"
+                      << std::endl;
+            return 2;
+        }
+    }
+
+    if (!fileExists("models/yolov5s.onnx") || !fileExists(screeningModel)) {
+        std::cout << "缺少完整模型或筛选模型（" << screeningModel << "），跳过检查" << std::endl;
+        return kSkipped;
+    }
+    if (screeningInput == 640) {
+        std::cerr << "筛选模型的输入尺寸须与完整模型不同，才会走补做预处理的路径" << std::endl;
+        return 2;
+    }
+    if (!writeFrames(frames)) {
+        std::cerr << "无法生成测试帧（需要仓库根目录的travellama.png）" << std::endl;
+        return 2;
+    }
+
+    std::vector<Detection> cascaded;
+    {
+        VisionProcessor processor;
+        processor.setCascadeDetection(true, screeningModel, screeningInput, 1);
+        if (!runPipeline(processor, frames, maxSeconds, cascaded)) {
+            return 2;
+        }
+        if (processor.getCascadeEscalationRatio() <= 0.0f) {
+            std::cerr << "筛选模型没有加载，级联检测未生效" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<Detection> reference;
+    {
+        VisionProcessor processor;
+        if (!runPipeline(processor, frames, maxSeconds, reference)) {
+            return 2;
+        }
+    }
+
+    std::cout << "级联+分块 " << cascaded.size() << " 个检测框，只分块 " << reference.size() << " 个检测框" << std::endl;
+    if (reference.empty()) {
+        std::cout << "测试帧上没有检测结果，无法比较，跳过检查" << std::endl;
+        return kSkipped;
+    }
+    if (!sameDetections(cascaded, reference)) {
+        std::cerr << "级联检测升级后的分块推理结果与只分块推理不一致" << std::endl;
+        return 1;
+    }
+    std::cout << "级联检测与分块推理同时启用时结果一致" << std::endl;
+    return 0;
+}